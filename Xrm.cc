@@ -179,21 +179,24 @@ Listed from weakest to strongest:
       }
   }
 
-  //  Now, check the display's RESOURCE_MANAGER property...
-  char* displayString = XResourceManagerString (display);
-  if (displayString != NULL)
+  //  Now, check the display's RESOURCE_MANAGER property, and this screen
+  //  of the display, if there is one (there is not for --record).
+  if (display != NULL)
   {
-    XrmDatabase displayrdb = XrmGetStringDatabase (displayString);
-    XrmMergeDatabases (displayrdb, &_db);  //  Destroys displayrdb when done.
-  }
+    char* displayString = XResourceManagerString (display);
+    if (displayString != NULL)
+    {
+      XrmDatabase displayrdb = XrmGetStringDatabase (displayString);
+      XrmMergeDatabases (displayrdb, &_db);  //  Destroys displayrdb when done.
+    }
 
-  //  And check this screen of the display...
-  char* screenString =
-              XScreenResourceString (DefaultScreenOfDisplay(display));
-  if (screenString != NULL)
-  {
-    XrmDatabase screenrdb = XrmGetStringDatabase (screenString);
-    XrmMergeDatabases (screenrdb, &_db);  //  Destroys screenrdb when done.
+    char* screenString =
+                XScreenResourceString (DefaultScreenOfDisplay(display));
+    if (screenString != NULL)
+    {
+      XrmDatabase screenrdb = XrmGetStringDatabase (screenString);
+      XrmMergeDatabases (screenrdb, &_db);  //  Destroys screenrdb when done.
+    }
   }
 
   //  Now, check for a user resource file, and merge it in if there is one...
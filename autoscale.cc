@@ -0,0 +1,94 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#include "autoscale.h"
+#include "xosview.h"
+#include "timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+
+AutoScale::AutoScale( void )
+  : nsecs_(0), hysteresis_(0.25), snap_(NONE), scale_(0) {
+}
+
+void AutoScale::configure( XOSView *parent, const char *prefix ){
+  char name[128];
+
+  snprintf(name, sizeof(name), "%sAutoscaleWindow", prefix);
+  double secs = atof(parent->getResourceOrUseDefault(name, "60"));
+
+  snprintf(name, sizeof(name), "%sAutoscaleHysteresis", prefix);
+  double hysteresis = atof(parent->getResourceOrUseDefault(name, "0.25"));
+
+  snprintf(name, sizeof(name), "%sAutoscaleSnap", prefix);
+  const char *snap = parent->getResourceOrUseDefault(name, "none");
+  if (!strncasecmp(snap, "pow2", 4))
+    configure(secs, hysteresis, POW2);
+  else if (!strncmp(snap, "125", 3))
+    configure(secs, hysteresis, STEPS125);
+  else
+    configure(secs, hysteresis, NONE);
+}
+
+void AutoScale::configure( double secs, double hysteresis, Snap snap ){
+  nsecs_ = secs > 0 ? (unsigned long long)(secs * 1e9) : 0;
+  hysteresis_ = hysteresis;
+  if (hysteresis_ < 0)
+    hysteresis_ = 0;
+  if (hysteresis_ > 1)
+    hysteresis_ = 1;
+  snap_ = snap;
+
+  window_.clear();
+  scale_ = 0;
+}
+
+double AutoScale::update( double value, double floor, unsigned long long when ){
+  if (!when)
+    when = Timer::nsecs();
+
+  //  The values that can no longer be the largest go, and so do the
+  //  ones that have left the window.
+  while (!window_.empty() && window_.back().value <= value)
+    window_.pop_back();
+  Sample s = { when, value };
+  window_.push_back(s);
+  while (window_.size() > 1 && when - window_.front().when > nsecs_)
+    window_.pop_front();
+
+  double max = window_.front().value;
+  double target = snap(max, snap_);
+  if (target < floor)
+    target = floor;
+
+  if (target > scale_ || max < scale_ * (1 - hysteresis_))
+    scale_ = target;
+  return scale_;
+}
+
+double AutoScale::snap( double value, Snap snap ){
+  if (value <= 0 || snap == NONE)
+    return value;
+
+  double p = pow(10, floor(log10(value)));
+  switch (snap) {
+  case POW2:
+    return pow(2, ceil(log2(value)));
+  case STEPS125:
+    if (value <= p)
+      return p;
+    if (value <= 2 * p)
+      return 2 * p;
+    if (value <= 5 * p)
+      return 5 * p;
+    return 10 * p;
+  default:
+    return value;
+  }
+}
@@ -0,0 +1,60 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _AUTOSCALE_H_
+#define _AUTOSCALE_H_
+
+//
+//  The full scale of a rate meter: the largest value seen over the last
+//  <meter>AutoscaleWindow seconds (0 for the latest sample alone), but
+//  no less than the meter's own floor (diskBandwidth, say).  It goes up
+//  as soon as a larger value comes in, and only comes down once the
+//  largest value in the window is <meter>AutoscaleHysteresis (a fraction)
+//  under the scale, so that it does not flicker.  <meter>AutoscaleSnap
+//  rounds it up to a power of two (pow2) or to 1, 2 or 5 times a power of
+//  ten (125), or not at all (none).
+//
+//  The largest value in the window is the front of a deque of the values
+//  that are larger than all that came after them, so each sample costs
+//  O(1) amortised however long the window is.
+//
+
+#include <deque>
+
+class XOSView;
+
+
+class AutoScale {
+public:
+  enum Snap { NONE, POW2, STEPS125 };
+
+  AutoScale( void );
+
+  //  Reads the <prefix>Autoscale... resources.
+  void configure( XOSView *parent, const char *prefix );
+  //  The same from the values of the resources, and starts over.
+  void configure( double secs, double hysteresis, Snap snap );
+
+  //  Takes a sample taken at when (nsecs on Timer's clock, now if 0) and
+  //  returns the scale, which is at least floor.
+  double update( double value, double floor, unsigned long long when = 0 );
+  double scale( void ) const { return scale_; }
+
+  static double snap( double value, Snap snap );
+
+private:
+  struct Sample {
+    unsigned long long when;
+    double value;
+  };
+  std::deque<Sample> window_;
+  unsigned long long nsecs_;
+  double hysteresis_;
+  Snap snap_;
+  double scale_;
+};
+
+#endif
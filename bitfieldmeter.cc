@@ -35,7 +35,6 @@ BitFieldMeter::BitFieldMeter( XOSView *parent, int numBits, int numfields,
   lastvals_ = NULL;
   lastx_ = NULL;
   setNumBits(numBits);
-  fieldLegend_ = NULL;
   setfieldlegend(FieldLegend);
   setNumFields(numfields);
 }
@@ -167,41 +166,17 @@ void BitFieldMeter::draw( void ){
 }
 
 void BitFieldMeter::drawfieldlegend( void ){
-  char *tmp1, *tmp2, buff[100];
-  int n, x = x_ + width_/2 + 4;
-
-  tmp1 = tmp2 = fieldLegend_;
-  for ( int i = 0 ; i < numfields_ ; i++ ){
-    n = 0;
-    while ( (*tmp2 != '/') && (*tmp2 != '\0') ){
-      if ( (*tmp2 == '\\') && (*(tmp2 + 1) == '/') ) // allow '/' in field as '\/'
-        memmove( tmp2, tmp2 + 1, strlen(tmp2) );
-      tmp2++;
-      n++;
-    }
-    tmp2++;
-    strncpy( buff, tmp1, n );
-    buff[n] = '\0';
-    parent_->setStippleN(i%4);
-    parent_->setForeground( colors_[i] );
-    parent_->drawString( x, y_ - 5, buff );
-    x += parent_->textWidth( buff, n );
-    parent_->setForeground( parent_->foreground() );
-    if ( i != numfields_ - 1 )
-      parent_->drawString( x, y_ - 5, "/" );
-    x += parent_->textWidth( "/", 1 );
-    tmp1 = tmp2;
-  }
-  parent_->setStippleN(0);	/*  Restore default all-bits stipple.  */
+  fieldLegend_.draw( parent_, x_ + width_/2 + 4, y_ - 5, colors_, numfields_ );
 }
 
 void BitFieldMeter::drawused( int mandatory ){
+  if ( !mandatory && !parent_->labelsDue() )
+    return;
   if ( !mandatory )
     if ( lastused_ == used_ )
       return;
 
   parent_->setStippleN(0);	/*  Use all-bits stipple.  */
-  static const int onechar = parent_->textWidth( "X" );
   if (!usedoffset_)  // metric meters need extra space for '-' sign
     usedoffset_ = ( metric_ ? parent_->textWidth( "XXXXXX" )
                             : parent_->textWidth( "XXXXX" ) );
@@ -237,11 +212,8 @@ void BitFieldMeter::drawused( int mandatory ){
       snprintf( buf, 10, "%.0f", used_ );
   }
 
-  parent_->clear( x_ - usedoffset_, y_ + height_ - parent_->textHeight(),
-                  usedoffset_ - onechar / 2, parent_->textHeight() + 1 );
-  parent_->setForeground( usedcolor_ );
-  parent_->drawString( x_ - (strlen( buf ) + 1 ) * onechar + 2,
-                       y_ + height_, buf );
+  usedLabel_.draw( parent_, x_, y_ + height_, usedoffset_, usedcolor_, buf,
+                   mandatory );
   lastused_ = used_;
 }
 
@@ -256,11 +228,8 @@ void BitFieldMeter::drawBits( int mandatory ){
 
   for ( int i = 0 ; i < numbits_ ; i++ ){
     if ( (bits_[i] != lastbits_[i]) || mandatory ){
-      if ( bits_[i] && pass )
-	parent_->setForeground( onColor_ );
-      else
-	parent_->setForeground( offColor_ );
-      parent_->drawFilledRectangle( x1, y_, w, height_);
+      parent_->fillRectangle( (bits_[i] && pass) ? onColor_ : offColor_, 0,
+                              x1, y_, w, height_);
     }
 
     lastbits_[i] = bits_[i];
@@ -294,10 +263,8 @@ void BitFieldMeter::drawfields( int mandatory ){
       twidth = width_ + x_ - x;
 
     if ( mandatory || (twidth != lastvals_[i]) || (x != lastx_[i]) ){
-      parent_->setForeground( colors_[i] );
-      parent_->setStippleN(i%4);
-      parent_->drawFilledRectangle( x, y_, twidth, height_ );
-      parent_->setStippleN(0);	/*  Restore all-bits stipple.  */
+      parent_->fillRectangle( colors_[i], i%4, x, y_,
+                              twidth - (i < numfields_ - 1), height_ );
       lastvals_[i] = twidth;
       lastx_[i] = x;
 
@@ -361,9 +328,5 @@ bool BitFieldMeter::checkX(int x, int width) const {
 
 
 void BitFieldMeter::setfieldlegend( const char *fieldlegend ){
-  delete[] fieldLegend_;
-  int len = strlen(fieldlegend);
-  fieldLegend_ = new char[len + 1];
-  strncpy( fieldLegend_, fieldlegend, len );
-  fieldLegend_[len] = '\0'; // strncpy() will not null terminate if s2 > len
+  fieldLegend_.set( fieldlegend );
 }
@@ -11,6 +11,8 @@
 #include "meter.h"
 #include "xosview.h"
 #include "timer.h"
+#include "usedlabel.h"
+#include "legend.h"
 
 
 class BitFieldMeter : public Meter {
@@ -49,6 +51,7 @@ protected:
   int *lastvals_, *lastx_;
   unsigned long *colors_;
   unsigned long usedcolor_;
+  UsedLabel usedLabel_;
   UsedType print_;
   int printedZeroTotalMesg_;
   int numWarnings_;
@@ -66,7 +69,7 @@ protected:
 
   void setNumFields(int n);
   void setNumBits(int n);
-  char *fieldLegend_;
+  Legend fieldLegend_;
 
   void setfieldlegend(const char *fieldlegend);
 
@@ -62,12 +62,8 @@ void BitMeter::drawBits( int mandatory ){
       x2 = x_ + (width_+1) - 1;
 
     if ( (bits_[i] != lastbits_[i]) || mandatory ){
-      if ( bits_[i] && pass )
-	parent_->setForeground( onColor_ );
-      else
-	parent_->setForeground( offColor_ );
-
-      parent_->drawFilledRectangle( x1, y_, x2 - x1, height_);
+      parent_->fillRectangle( (bits_[i] && pass) ? onColor_ : offColor_, 0,
+                              x1, y_, x2 - x1, height_);
     }
 
     lastbits_[i] = bits_[i];
@@ -0,0 +1,70 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#include "counterrates.h"
+#include "timer.h"
+
+
+CounterRates::CounterRates( int n, int bits )
+  : when_(0), secs_(0), wraps_(0), resets_(0) {
+  resize(n, bits);
+}
+
+void CounterRates::resize( int n, int bits ){
+  int old = size();
+
+  prev_.resize(n, 0);
+  delta_.resize(n, 0);
+  mask_.resize(n, 0);
+  primed_.resize(n, false);
+  for (int i = old ; i < n ; i++)
+    CounterRates::bits(i, bits);
+}
+
+void CounterRates::bits( int i, int bits ){
+  mask_[i] = bits >= 64 ? ~0ULL : (1ULL << bits) - 1;
+}
+
+void CounterRates::restart( void ){
+  for (int i = 0 ; i < size() ; i++)
+    primed_[i] = false;
+  when_ = 0;
+}
+
+bool CounterRates::update( const unsigned long long *counters,
+                           unsigned long long when ){
+  int n = size();
+  bool first = !when_;
+
+  if (!when)
+    when = Timer::nsecs();
+  secs_ = first ? 0 : (when - when_) / 1e9;
+  when_ = when;
+
+  for (int i = 0 ; i < n ; i++) {
+    unsigned long long cur = counters[i], prev = prev_[i];
+    unsigned long long d = 0;
+
+    if (!primed_[i])
+      primed_[i] = true;
+    else if (cur >= prev)
+      d = cur - prev;
+    else {
+      unsigned long long mask = mask_[i];
+      unsigned long long wrapped = (cur - prev) & mask;
+      if (cur <= mask && prev <= mask && wrapped <= mask / 2) {
+        d = wrapped;
+        wraps_++;
+      }
+      else
+        resets_++;
+    }
+    delta_[i] = d;
+    prev_[i] = cur;
+  }
+
+  return !first;
+}
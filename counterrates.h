@@ -0,0 +1,62 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _COUNTERRATES_H_
+#define _COUNTERRATES_H_
+
+//
+//  Turns a set of ever increasing counters (bytes sent, sectors read,
+//  interrupts, ...) into how much each went up since the last update()
+//  and the rate per second, timed on Timer's (monotonic) clock.
+//
+//  A counter that goes down either wrapped around, if it is narrower
+//  than 64 bits (see bits()) and the wrapped difference is under half
+//  its range, or was reset (the driver reloaded, an interface went
+//  away), in which case it counts as not having moved.  A counter has
+//  no difference until it has been seen twice, so the first update()
+//  after construction, restart() or resize() shows nothing rather than
+//  everything counted since boot.
+//
+
+#include <vector>
+
+
+class CounterRates {
+public:
+  CounterRates( int n = 0, int bits = 64 );
+
+  int size( void ) const { return prev_.size(); }
+  //  Counters added are bits wide and have not been seen yet.
+  void resize( int n, int bits = 64 );
+  void bits( int i, int bits );
+
+  //  Forget the last value of counter i, or of all of them.
+  void restart( int i ) { primed_[i] = false; }
+  void restart( void );
+
+  //  Takes the size() counters, read at when (nsecs on Timer's clock,
+  //  now if 0).  False if there was no earlier update() to compare with.
+  bool update( const unsigned long long *counters,
+               unsigned long long when = 0 );
+
+  unsigned long long last( int i ) const { return prev_[i]; }
+  unsigned long long delta( int i ) const { return delta_[i]; }
+  double rate( int i ) const { return secs_ > 0 ? delta_[i] / secs_ : 0; }
+  //  The time between the last two update()s.
+  double secs( void ) const { return secs_; }
+
+  unsigned long wraps( void ) const { return wraps_; }
+  unsigned long resets( void ) const { return resets_; }
+
+private:
+  std::vector<unsigned long long> prev_, delta_, mask_;
+  std::vector<bool> primed_;
+  unsigned long long when_;
+  double secs_;
+  unsigned long wraps_, resets_;
+};
+
+#endif
@@ -0,0 +1,239 @@
+//
+// Do not edit this file.
+// This file is generated automagically from Xdefaults
+// using the awk program found in defresources.awk.
+// This file will be rebuilt when Xdefaults is modified.
+//
+
+const char *defaultXResourceString = "xosview*captions:           True\n\
+xosview*labels:             True\n\
+xosview*meterLabelColor:    wheat\n\
+xosview*usedlabels:         True\n\
+xosview*usedLabelColor:     wheat\n\
+xosview*borderwidth:        1\n\
+xosview*font:               7x13bold\n\
+xosview*background:         navy\n\
+xosview*foreground:         wheat\n\
+xosview*enableStipple:	    False ! Change to true to try beta stipple support.\n\
+xosview*samplesPerSec:      10\n\
+xosview*framesPerSec:       0     ! 0 draws after every sample\n\
+xosview*samplerThread:      False ! sample meters apart from drawing\n\
+xosview*recordSync:         10    ! secs between syncs of a --record file\n\
+xosview*obscuredSampleDivisor: 4   ! sample less often while hidden\n\
+xosview*backBuffer:         False ! draw off-screen, copy to the window\n\
+xosview*graphImage:         False ! redraw graphs as one image\n\
+xosview*remoteMode:         Auto  ! send less to a display on another host\n\
+xosview*maxXBytesPerSec:    0     ! draw less often above this; 0 for no limit\n\
+xosview*decayHalfLife:      2.3   ! secs for the decay average to halve\n\
+xosview*peakOverlay:        False\n\
+xosview*peakWindow:         60    ! secs the peak and 95th percentile are over\n\
+xosview*peakColor:          red\n\
+xosview*p95Color:           orange\n\
+xosview*graphNumCols:       135   ! number of samples shown in a graph\n\
+xosview*history:            True\n\
+xosview*historyTiers:       1x600 10x2160\n\
+xosview*load:               True\n\
+xosview*loadCritColor:      red\n\
+xosview*loadWarnColor:      orange\n\
+xosview*loadProcColor:      seagreen\n\
+xosview*loadIdleColor:      aquamarine\n\
+xosview*loadPriority:       20\n\
+xosview*loadCritThreshold:  auto  ! auto or number\n\
+xosview*loadWarnThreshold:  auto  ! auto or number\n\
+xosview*loadDecay:          False\n\
+xosview*loadGraph:          False\n\
+xosview*loadUsedFormat:     float\n\
+xosview*loadCpuSpeed:       True\n\
+xosview*loadAutoscaleWindow: 0\n\
+xosview*loadAutoscaleHysteresis: 0.8\n\
+xosview*loadAutoscaleSnap:  pow2\n\
+xosview*gfx:               True\n\
+xosview*gfxCritColor:      red\n\
+xosview*gfxWarnColor:      orange\n\
+xosview*gfxSwapColor:      seagreen\n\
+xosview*gfxIdleColor:      aquamarine\n\
+xosview*gfxPriority:       1    ! don't change, until you know what you do\n\
+xosview*gfxCritThreshold:  120  ! swapbuffers/s per pipe\n\
+xosview*gfxWarnThreshold:  60   ! swapbuffers/s per pipe\n\
+xosview*gfxDecay:          False\n\
+xosview*gfxGraph:          False\n\
+xosview*gfxUsedFormat:	   autoscale\n\
+xosview*cpu:                True\n\
+xosview*cpuFields:          USR SYS WIO IDLE\n\
+xosview*cpuUserColor:       seagreen\n\
+xosview*cpuNiceColor:       yellow\n\
+xosview*cpuSystemColor:     orange\n\
+xosview*cpuInterruptColor:  lightblue\n\
+xosview*cpuSInterruptColor: orange red\n\
+xosview*cpuWaitColor:       red\n\
+xosview*cpuFreeColor:       aquamarine\n\
+xosview*cpuGuestColor:      blue\n\
+xosview*cpuNiceGuestColor:  gold\n\
+xosview*cpuStolenColor:     purple\n\
+xosview*cpuPriority:        1\n\
+xosview*cpuDecay:           True\n\
+xosview*cpuGraph:           True\n\
+xosview*cpuUsedFormat:	    percent\n\
+xosview*cpuFormat:          auto   ! single, all, auto or both\n\
+xosview*mem:                True\n\
+xosview*memKernelColor:     yellow\n\
+xosview*memUsedColor:       seagreen\n\
+xosview*memSharedColor:     SkyBlue\n\
+xosview*memBufferColor:     red\n\
+xosview*memSlabColor:	    blue\n\
+xosview*memMapColor:	    SlateBlue1\n\
+xosview*memCacheColor:      orange\n\
+xosview*memFreeColor:       aquamarine\n\
+xosview*memTextColor:       blue\n\
+xosview*memOtherColor:      orange\n\
+xosview*memActiveColor:	    blue\n\
+xosview*memInactiveColor:   lightblue\n\
+xosview*memWiredColor:      orange\n\
+xosview*memPriority:        10\n\
+xosview*memDecay:           False\n\
+xosview*memGraph:           False\n\
+xosview*memUsedFormat:	    autoscale\n\
+xosview*swap:               True\n\
+xosview*swapUsedColor:      seagreen\n\
+xosview*swapFreeColor:      aquamarine\n\
+xosview*swapPriority:       10\n\
+xosview*swapDecay:          False\n\
+xosview*swapGraph:          False\n\
+xosview*swapUsedFormat:	    autoscale\n\
+xosview*page:               True\n\
+xosview*pageBandwidth:      120\n\
+xosview*pageInColor:        SkyBlue\n\
+xosview*pageOutColor:       SlateBlue1\n\
+xosview*pageIdleColor:      aquamarine\n\
+xosview*pagePriority:       5\n\
+xosview*pageDecay:          False\n\
+xosview*pageGraph:          False\n\
+xosview*pageUsedFormat:     autoscale\n\
+xosview*net:		    True\n\
+xosview*netBandwidth:       10000000  ! for 100Mbit/s\n\
+xosview*netInColor:         SkyBlue\n\
+xosview*netOutColor:        SlateBlue1\n\
+xosview*netBackground:      aquamarine\n\
+xosview*netPriority:        2\n\
+xosview*netDecay:           True\n\
+xosview*netGraph:           True\n\
+xosview*netUsedFormat:	    autoscale\n\
+xosview*netIface:           False\n\
+xosview*netAutoscaleWindow: 60\n\
+xosview*netAutoscaleSnap:   125\n\
+xosview*serial0:            False\n\
+xosview*serial1:            False\n\
+xosview*serial2:            False\n\
+xosview*serial3:            False\n\
+xosview*serial4:            False\n\
+xosview*serial5:            False\n\
+xosview*serial6:            False\n\
+xosview*serial7:            False\n\
+xosview*serial8:            False\n\
+xosview*serial9:            False\n\
+xosview*serialOnColor:      red\n\
+xosview*serialOffColor:     aquamarine\n\
+xosview*serialPriority:     1\n\
+xosview*interrupts:         False\n\
+xosview*intSeparate:        False\n\
+xosview*intOnColor:         red\n\
+xosview*intOffColor:        aquamarine\n\
+xosview*intPriority:	    1\n\
+xosview*irqrate:	False\n\
+xosview*irqrateUsedColor:	red\n\
+xosview*irqrateIdleColor:	aquamarine\n\
+xosview*irqratePriority:	1\n\
+xosview*irqrateUsedFormat:  autoscale\n\
+xosview*irqrateDecay:	True\n\
+xosview*irqrateGraph:	False\n\
+xosview*irqrateAutoscaleWindow:	60\n\
+xosview*irqrateAutoscaleSnap:	125\n\
+xosview*battery:            True\n\
+xosview*batteryLeftColor:   orange\n\
+xosview*batteryUsedColor:   aquamarine\n\
+xosview*batteryPriority:    50\n\
+xosview*batteryUsedFormat:  percent\n\
+xosview*batteryChargeColor: seagreen\n\
+xosview*batteryFullColor:   magenta\n\
+xosview*batteryLowColor:    red\n\
+xosview*batteryCritColor:   red\n\
+xosview*batteryNoneColor:   grey\n\
+xosview*wireless:            True\n\
+xosview*PoorQualityColor:    red\n\
+xosview*FairQualityColor:    orange\n\
+xosview*GoodQualityColor:    seagreen\n\
+xosview*wirelessUsedColor:   aquamarine\n\
+xosview*wirelessPriority:    1\n\
+xosview*wirelessUsedFormat:  autoscale\n\
+xosview*wirelessDecay:       True\n\
+xosview*disk:		    True\n\
+xosview*diskUsedColor:	    seagreen\n\
+xosview*diskIdleColor:	    aquamarine\n\
+xosview*diskWriteColor:     SlateBlue1\n\
+xosview*diskReadColor:      SkyBlue\n\
+xosview*diskBandwidth:      100000000 ! 100MB/s\n\
+xosview*diskPriority:	    10\n\
+xosview*diskDecay:	    True\n\
+xosview*diskUsedFormat:     autoscale\n\
+xosview*diskGraph:	    True\n\
+xosview*diskAutoscaleWindow: 60\n\
+xosview*diskAutoscaleSnap:  125\n\
+xosview*RAID:                 False\n\
+xosview*RAIDdevicecount:      1\n\
+xosview*RAIDdiskOnlineColor:  green\n\
+xosview*RAIDdiskFailureColor: red\n\
+xosview*RAIDresyncdoneColor:  yellow\n\
+xosview*RAIDresynctodoColor:  red\n\
+xosview*RAIDresynccompleteColor:  green\n\
+xosview*RAIDPriority:         20\n\
+xosview*RAIDUsedFormat:       percent\n\
+xosview*horizontalMargin:      5\n\
+xosview*verticalMargin:        5\n\
+xosview*verticalSpacing:       5\n\
+xosview*lmstemp:	False\n\
+xosview*lmstempActColor:	blue\n\
+xosview*lmstempHighColor:	red\n\
+xosview*lmstempLowColor:       orange\n\
+xosview*lmstempIdleColor:      aquamarine\n\
+xosview*lmstempPriority: 20\n\
+xosview*lmstempUsedFormat: autoscale\n\
+xosview*NFSDStats:       False\n\
+xosview*NFSDStatCallsColor:     green\n\
+xosview*NFSDStatBadCallsColor: red\n\
+xosview*NFSDStatUDPColor:       yellow\n\
+xosview*NFSDStatTCPColor:       orange\n\
+xosview*NFSDStatIdleColor:      aquamarine\n\
+xosview*NFSDStatDecay:		True\n\
+xosview*NFSDStatGraph:		False\n\
+xosview*NFSDStatUsedFormat:	percent\n\
+xosview*NFSStats:       False\n\
+xosview*NFSStatReTransColor:    red\n\
+xosview*NFSStatAuthRefrshColor: yellow\n\
+xosview*NFSStatCallsColor:      SkyBlue\n\
+xosview*NFSStatIdleColor:       aquamarine\n\
+xosview*NFSStatDecay:		True\n\
+xosview*NFSStatGraph:		False\n\
+xosview*NFSStatUsedFormat:	percent\n\
+xosview*acpitemp:                 False\n\
+xosview*acpitempActColor:         blue\n\
+xosview*acpitempHighColor:        red\n\
+xosview*acpitempIdleColor:        aquamarine\n\
+xosview*acpitempPriority:         20\n\
+xosview*acpitempUsedFormat:       float\n\
+xosview*acpitempHighest:          100\n\
+xosview*coretemp:                 False\n\
+xosview*coretempActColor:         blue\n\
+xosview*coretempHighColor:        red\n\
+xosview*coretempIdleColor:        aquamarine\n\
+xosview*coretempPriority:         20\n\
+xosview*coretempUsedFormat:       float\n\
+xosview*coretempDisplayType:      separate    ! separate, maximum or average\n\
+xosview*bsdsensor:               False\n\
+xosview*bsdsensorActColor:       blue\n\
+xosview*bsdsensorHighColor:      red\n\
+xosview*bsdsensorLowColor:       orange\n\
+xosview*bsdsensorIdleColor:      aquamarine\n\
+xosview*bsdsensorPriority:       20\n\
+xosview*bsdsensorUsedFormat:     float\n\
+";
+
@@ -25,10 +25,24 @@ FieldMeter::FieldMeter( XOSView *parent, int numfields, const char *title,
   usedoffset_ = 0;
   used_ = 0;
   lastused_ = -1;
+  state_ = 0;
+  showntotal_ = shownused_ = 0;
+  shownusedmin_ = shownusedmax_ = 0;
+  shownstate_ = 0;
+  shownperiods_ = 1;
+  latches_ = latchedsamples_ = 0;
   fields_ = NULL;
+  shownfields_ = NULL;
+  accfields_ = latchedfields_ = NULL;
+  accn_ = 0;
+  snapshot_ = NULL;
+  snapshotseq_ = consumed_ = 0;
   colors_ = NULL;
   lastvals_ = NULL;
   lastx_ = NULL;
+  peaks_ = NULL;
+  peakcolor_ = p95color_ = 0;
+  peakpos_ = p95pos_ = -1;
   setNumFields(numfields);
 }
 
@@ -41,19 +55,37 @@ FieldMeter::disableMeter ( )
   // And specify the total of 1.0, so the meter is grayed out.
   total_ = 1.0;
   fields_[0] = 1.0;
+  publish();
 }
 
 
 FieldMeter::~FieldMeter( void ){
   delete[] fields_;
+  delete[] shownfields_;
+  delete[] accfields_;
+  delete[] latchedfields_;
   delete[] colors_;
   delete[] lastvals_;
   delete[] lastx_;
+  delete snapshot_;
+  delete peaks_;
 }
 
 void FieldMeter::checkResources( void ){
   Meter::checkResources();
   usedcolor_ = parent_->allocColor( parent_->getResource( "usedLabelColor") );
+
+  delete peaks_;
+  peaks_ = NULL;
+  peakpos_ = p95pos_ = -1;
+  if ( parent_->isResourceTrue( "peakOverlay" ) ){
+    //  A meter takes new values at most once a sample.
+    double secs = atof( parent_->getResourceOrUseDefault( "peakWindow",
+                                                          "60" ) );
+    peaks_ = new PeakSketch( secs, (int)(secs * MAX_SAMPLES_PER_SECOND) + 1 );
+    peakcolor_ = parent_->allocColor( parent_->getResource( "peakColor" ) );
+    p95color_ = parent_->allocColor( parent_->getResource( "p95Color" ) );
+  }
 }
 
 
@@ -134,8 +166,6 @@ void FieldMeter::draw( void ){
 }
 
 void FieldMeter::drawlegend( void ){
-  char *tmp1, *tmp2, buff[100];
-  int n, x = x_;
 
   if (!docaptions_ || !dolegends_)
     return;
@@ -143,49 +173,28 @@ void FieldMeter::drawlegend( void ){
   parent_->clear( x_, y_ - 5 - parent_->textHeight(),
                   width_ + 5, parent_->textHeight() + 4 );
 
-  tmp1 = tmp2 = legend_;
-  for ( int i = 0 ; i < numfields_ ; i++ ){
-    n = 0;
-    while ( (*tmp2 != '/') && (*tmp2 != '\0') ){
-      if ( (*tmp2 == '\\') && (*(tmp2 + 1) == '/') ) // allow '/' in field as '\/'
-        memmove( tmp2, tmp2 + 1, strlen(tmp2) );
-      tmp2++;
-      n++;
-    }
-    tmp2++;
-    strncpy( buff, tmp1, n );
-    buff[n] = '\0';
-    parent_->setStippleN(i%4);
-    parent_->setForeground( colors_[i] );
-    parent_->drawString( x, y_ - 5, buff );
-    x += parent_->textWidth( buff, n );
-    parent_->setForeground( parent_->foreground() );
-    if ( i != numfields_ - 1 )
-      parent_->drawString( x, y_ - 5, "/" );
-    x += parent_->textWidth( "/", 1 );
-    tmp1 = tmp2;
-  }
-  parent_->setStippleN(0);	/*  Restore default all-bits stipple.  */
+  legendFields_.draw( parent_, x_, y_ - 5, colors_, numfields_ );
 }
 
 void FieldMeter::drawused( int mandatory ){
+  if ( !mandatory && !parent_->labelsDue() )
+    return;
   if ( !mandatory )
-    if ( lastused_ == used_ )
+    if ( lastused_ == shownused_ )
       return;
 
   parent_->setStippleN(0);	/*  Use all-bits stipple.  */
-  static const int onechar = parent_->textWidth( "X" );
   if (!usedoffset_)  // metric meters need extra space for '-' sign
     usedoffset_ = ( metric_ ? parent_->textWidth( "XXXXXX" )
                             : parent_->textWidth( "XXXXX" ) );
   char buf[10];
 
   if (print_ == PERCENT){
-    snprintf( buf, 10, "%d%%", (int)used_ );
+    snprintf( buf, 10, "%d%%", (int)shownused_ );
   }
   else if (print_ == AUTOSCALE){
     char scale[2];
-    double scaled_used = scaleValue(used_, scale, metric_);
+    double scaled_used = scaleValue(shownused_, scale, metric_);
     /*  For now, we can only print 3 characters, plus the optional sign and
      *  suffix, without overprinting the legends.  Thus, we can
      *  print 965, or we can print 34, but we can't print 34.7 (the
@@ -204,75 +213,246 @@ void FieldMeter::drawused( int mandatory ){
     }
   }
   else {
-    if ( fabs(used_) < 99.95 )
-      snprintf( buf, 10, "%.1f", used_ );
+    if ( fabs(shownused_) < 99.95 )
+      snprintf( buf, 10, "%.1f", shownused_ );
     else  // drop the decimal if the string gets too long
-      snprintf( buf, 10, "%.0f", used_ );
+      snprintf( buf, 10, "%.0f", shownused_ );
   }
 
-  parent_->clear( x_ - usedoffset_, y_ + height_ - parent_->textHeight(),
-                  usedoffset_ - onechar / 2, parent_->textHeight() + 1 );
-  parent_->setForeground( usedcolor_ );
-  parent_->drawString( x_ - (strlen( buf ) + 1 ) * onechar + 2,
-                       y_ + height_, buf );
-  lastused_ = used_;
+  usedLabel_.draw( parent_, x_, y_ + height_, usedoffset_, usedcolor_, buf,
+                   mandatory );
+  lastused_ = shownused_;
 }
 
 void FieldMeter::drawfields( int mandatory ){
   int twidth, x = x_;
 
-  if ( total_ == 0 )
+  if ( !threaded_ )
+    latch();
+  if ( showntotal_ == 0 )
     return;
 
+  //  Markers that moved leave the fields to be drawn over again.
+  if ( placeOverlay( width_ ) )
+    mandatory = 1;
+  bool drew = false;
+
   for ( int i = 0 ; i < numfields_ ; i++ ){
     /*  Look for bogus values.  */
-    if (fields_[i] < 0.0 && !metric_) {
+    if (shownfields_[i] < 0.0 && !metric_) {
       /*  Only print a warning 5 times per meter, followed by a
        *  message about no more warnings.  */
       numWarnings_ ++;
       if (numWarnings_ < 5)
         std::cerr << "Warning: meter " << name() << " had a negative value of "
-                  << fields_[i] << " for field " << i << std::endl;
+                  << shownfields_[i] << " for field " << i << std::endl;
       if (numWarnings_ == 5)
         std::cerr << "Future warnings from the " << name() << " meter will not "
                   << "be displayed." << std::endl;
     }
 
-    twidth = (int)fabs(((width_ * fields_[i]) / total_));
+    twidth = (int)fabs(((width_ * shownfields_[i]) / showntotal_));
     if ( (i == numfields_ - 1) && ((x + twidth) != (x_ + width_)) )
       twidth = width_ + x_ - x;
 
     if ( mandatory || (twidth != lastvals_[i]) || (x != lastx_[i]) ){
-      parent_->setForeground( colors_[i] );
-      parent_->setStippleN(i%4);
-      parent_->drawFilledRectangle( x, y_, twidth, height_ );
-      parent_->setStippleN(0);	/*  Restore all-bits stipple.  */
+      //  The next field (redrawn too, since it moved) covers the
+      //  right edge.
+      parent_->fillRectangle( colors_[i], i%4, x, y_,
+                              twidth - (i < numfields_ - 1), height_ );
       lastvals_[i] = twidth;
       lastx_[i] = x;
+      drew = true;
     }
     x += twidth;
   }
+  if ( drew )
+    drawOverlay( height_ );
   if ( dousedlegends_ )
     drawused( mandatory );
 }
 
+bool FieldMeter::placeOverlay( int length ){
+  int peak = -1, p95 = -1;
+
+  if ( peaks_ && !peaks_->empty() ){
+    peak = (int)(peaks_->peak() * length + 0.5);
+    p95 = (int)(peaks_->quantile( 0.95 ) * length + 0.5);
+  }
+  if ( peak == peakpos_ && p95 == p95pos_ )
+    return false;
+  peakpos_ = peak;
+  p95pos_ = p95;
+  return true;
+}
+
+void FieldMeter::drawOverlay( int height ){
+  if ( p95pos_ >= 0 ){
+    parent_->setForeground( p95color_ );
+    parent_->drawLine( x_ + p95pos_, y_, x_ + p95pos_, y_ + height );
+  }
+  if ( peakpos_ >= 0 ){
+    parent_->setForeground( peakcolor_ );
+    parent_->drawLine( x_ + peakpos_, y_, x_ + peakpos_, y_ + height );
+  }
+}
+
+double FieldMeter::usedFraction( double used ) const {
+  if ( print_ == PERCENT )
+    return used / 100.0;
+  return showntotal_ ? used / showntotal_ : 0;
+}
+
+//  The used value of the values just latched goes into the peaks.
+void FieldMeter::addPeak( void ){
+  if ( peaks_ && showntotal_ )
+    peaks_->add( usedFraction( shownused_ ), usedFraction( shownusedmax_ ),
+                 Timer::nsecs() );
+}
+
 void FieldMeter::checkevent( void ){
-  drawfields(0);
+  sample();
+  publish();
+  render();
+}
+
+//  Adds the last sample to the ones to be shown on the next frame.
+//  The sampler thread hands the sums over in the snapshot, and never
+//  starts them over (latch() takes the difference), so only the range
+//  of the used value needs to know what the X thread has read.
+void FieldMeter::publish( void ){
+  if ( !accn_ ){
+    memset(accfields_, 0, numfields_ * sizeof(accfields_[0]));
+    acctotal_ = accused_ = 0;
+    accmin_ = accmax_ = used_;
+    accperiods_ = 0;
+  }
+
+  for ( int i = 0 ; i < numfields_ ; i++ )
+    accfields_[i] += fields_[i];
+  acctotal_ += total_;
+  accused_ += used_;
+  if ( used_ < accmin_ )
+    accmin_ = used_;
+  if ( used_ > accmax_ )
+    accmax_ = used_;
+  accperiods_ += periods_;
+  accn_++;
+
+  if ( threaded_ ){
+    unsigned long seq = snapshot_->seq() + 1;
+    unsigned long first = __atomic_load_n(&consumed_, __ATOMIC_ACQUIRE) + 1;
+    if ( seq - first >= USEDRING )
+      first = seq - USEDRING + 1;
+    usedring_[seq % USEDRING] = used_;
+    double usedmin = used_, usedmax = used_;
+    for ( unsigned long i = first ; i != seq ; i++ ){
+      if ( usedring_[i % USEDRING] < usedmin )
+        usedmin = usedring_[i % USEDRING];
+      if ( usedring_[i % USEDRING] > usedmax )
+        usedmax = usedring_[i % USEDRING];
+    }
+    snapshot_->publish(accfields_, acctotal_, accused_, usedmin, usedmax,
+                       state_, accperiods_, accn_);
+  }
+}
+
+void FieldMeter::render( void ){
+  if ( latch() )
+    drawfields(0);
+}
+
+//  Bring the shown values up to date.  Meters without splitSample()
+//  are shown as sampled.  The others are shown as the average of what
+//  they published since the last time, straight or from the snapshot
+//  published by the sampler thread.  Returns false if nothing new was
+//  published since the last time.
+bool FieldMeter::latch( void ){
+  if ( !threaded_ && !splitSample() ){
+    memcpy(shownfields_, fields_, numfields_ * sizeof(fields_[0]));
+    showntotal_ = total_;
+    shownused_ = shownusedmin_ = shownusedmax_ = used_;
+    shownstate_ = state_;
+    shownperiods_ = periods_;
+    if ( samples_ != latchedsamples_ ){
+      latchedsamples_ = samples_;
+      latches_++;
+      addPeak();
+    }
+    return true;
+  }
+
+  if ( !threaded_ ){
+    if ( !accn_ )
+      return false;
+    for ( int i = 0 ; i < numfields_ ; i++ )
+      shownfields_[i] = accfields_[i] / accn_;
+    showntotal_ = acctotal_ / accn_;
+    shownused_ = accused_ / accn_;
+    shownusedmin_ = accmin_;
+    shownusedmax_ = accmax_;
+    shownstate_ = state_;
+    shownperiods_ = columns(accperiods_);
+    accn_ = 0;
+    latches_++;
+    addPeak();
+    return true;
+  }
+
+  if ( snapshot_->seq() == snapshotseq_ )
+    return false;
+  double total, used;
+  unsigned long periods, n;
+  snapshotseq_ = snapshot_->read(shownfields_, &total, &used,
+                                 &shownusedmin_, &shownusedmax_,
+                                 &shownstate_, &periods, &n);
+  __atomic_store_n(&consumed_, snapshotseq_, __ATOMIC_RELEASE);
+
+  //  A new sequence number always brings at least one more sample.
+  unsigned long samples = n - latchedn_;
+  for ( int i = 0 ; i < numfields_ ; i++ ){
+    double sum = shownfields_[i];
+    shownfields_[i] = (sum - latchedfields_[i]) / samples;
+    latchedfields_[i] = sum;
+  }
+  showntotal_ = (total - latchedtotal_) / samples;
+  shownused_ = (used - latchedused_) / samples;
+  shownperiods_ = columns(periods - latchedperiods_);
+  latchedtotal_ = total;
+  latchedused_ = used;
+  latchedn_ = n;
+  latchedperiods_ = periods;
+  latches_++;
+  addPeak();
+  return true;
 }
 
 void FieldMeter::setNumFields(int n){
   numfields_ = n;
   delete[] fields_;
+  delete[] shownfields_;
+  delete[] accfields_;
+  delete[] latchedfields_;
   delete[] colors_;
   delete[] lastvals_;
   delete[] lastx_;
+  delete snapshot_;
   fields_ = new double[numfields_];
+  shownfields_ = new double[numfields_];
+  accfields_ = new double[numfields_];
+  latchedfields_ = new double[numfields_];
+  accn_ = 0;
+  latchedtotal_ = latchedused_ = 0;
+  latchedn_ = latchedperiods_ = 0;
   colors_ = new unsigned long[numfields_];
   lastvals_ = new int[numfields_];
   lastx_ = new int[numfields_];
+  snapshot_ = new Snapshot(numfields_);
+  snapshotseq_ = consumed_ = 0;
 
-  total_ = 0;
+  total_ = showntotal_ = 0;
   for ( int i = 0 ; i < numfields_ ; i++ ){
+    shownfields_[i] = latchedfields_[i] = 0.0;
     fields_[i] = 0.0;             /* egcs 2.91.66 bug !? don't do this and */
     lastvals_[i] = lastx_[i] = 0; /* that in a single statement or it'll   */
                                   /* overwrite too much with 0 ...         */
@@ -286,10 +466,10 @@ bool FieldMeter::checkX(int x, int width) const {
     std::cerr << "FieldMeter::checkX() : bad horiz values for meter : "
          << name() << std::endl;
 
-    std::cerr <<"value "<<x<<", width "<<width<<", total_ = "<<total_<<std::endl;
+    std::cerr <<"value "<<x<<", width "<<width<<", total_ = "<<showntotal_<<std::endl;
 
     for (int i = 0 ; i < numfields_ ; i++)
-      std::cerr <<"fields_[" <<i <<"] = " <<fields_[i] <<",";
+      std::cerr <<"fields_[" <<i <<"] = " <<shownfields_[i] <<",";
     std::cerr <<std::endl;
 
     return false;
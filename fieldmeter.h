@@ -10,6 +10,9 @@
 #include "meter.h"
 #include "xosview.h"
 #include "timer.h"
+#include "usedlabel.h"
+#include "snapshot.h"
+#include "peaksketch.h"
 
 
 class FieldMeter : public Meter {
@@ -29,7 +32,11 @@ public:
   void setUsed (double val, double total);
   void draw( void );
   void checkevent( void );
+  void publish( void );
+  void render( void );
   void disableMeter ( void );
+  int numValues( void ) const { return numfields_; }
+  const double *values( void ) const { return fields_; }
 
   virtual void checkResources( void );
 
@@ -39,24 +46,70 @@ protected:
   int numfields_;
   double *fields_;
   double total_, used_, lastused_;
+  //  For meters whose colors or legend follow the sample (see BtryMeter),
+  //  handed over along with the values.
+  int state_;
+  //  What drawfields() draws: the values above as of the last latch(),
+  //  averaged over the samples since the one before (see framesPerSec),
+  //  and the range of the used value over them.  shownperiods_ is in
+  //  graph columns (see Meter::columns()).
+  double *shownfields_;
+  double showntotal_, shownused_, shownusedmin_, shownusedmax_;
+  int shownstate_, shownperiods_;
+  //  Counts the latch()es that brought new values.
+  unsigned long latches_;
   int *lastvals_, *lastx_;
   unsigned long *colors_;
   unsigned long usedcolor_;
+  UsedLabel usedLabel_;
   UsedType print_;
   int printedZeroTotalMesg_;
   int numWarnings_;
   bool metric_;
   int usedoffset_;
+  //  The recent peak and 95th percentile of the used value, drawn as
+  //  markers over the meter (peakOverlay), and where they were drawn,
+  //  in pixels along it (-1 for none).
+  PeakSketch *peaks_;
+  unsigned long peakcolor_, p95color_;
+  int peakpos_, p95pos_;
 
   void SetUsedFormat ( const char * const str );
   void drawlegend( void );
   void drawused( int mandatory );
   bool checkX(int x, int width) const;
+  bool latch( void );
+  //  Works out where the markers go along a meter length pixels long.
+  //  True if that is not where they were drawn last.
+  bool placeOverlay( int length );
+  //  Draws them across the top height pixels of a bar.
+  void drawOverlay( int height );
 
   void setNumFields(int n);
 
 
 private:
+  enum { USEDRING = 64 };
+
+  Snapshot *snapshot_;
+  unsigned long snapshotseq_;
+  unsigned long consumed_;  // snapshotseq_, for the sampler thread
+  //  Sums of the samples published since the last latch(), or in the
+  //  sampler thread since the start (see Snapshot).
+  double *accfields_;
+  double acctotal_, accused_, accmin_, accmax_;
+  unsigned long accn_, accperiods_;
+  //  The sums read from the snapshot by the last latch().
+  double *latchedfields_;
+  double latchedtotal_, latchedused_;
+  unsigned long latchedn_, latchedperiods_;
+  //  The used value of the last samples the sampler thread published,
+  //  by sequence number, for the range of the ones not yet latched.
+  double usedring_[USEDRING];
+  unsigned long latchedsamples_;  // samples_ as of the last latch()
+
+  void addPeak( void );
+  double usedFraction( double used ) const;
   Timer _timer;
 protected:
   void IntervalTimerStart() { _timer.start(); }
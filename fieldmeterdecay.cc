@@ -25,7 +25,12 @@
 //	 dodecay_ variable according to the, e.g., xosview*cpuDecay resource.
 
 #include "fieldmeterdecay.h"
+#include "timer.h"
 #include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
 
 FieldMeterDecay::FieldMeterDecay( XOSView *parent,
@@ -39,6 +44,9 @@ FieldMeterDecay::FieldMeterDecay( XOSView *parent,
   lastDecayval_ = new double[numfields];
   firsttime_ = 1;
   dodecay_ = 1;
+  halfLife_ = 2.3;
+  decayed_ = 0;
+  lastDecay_ = 0;
 }
 
 FieldMeterDecay::~FieldMeterDecay( void ){
@@ -46,6 +54,47 @@ FieldMeterDecay::~FieldMeterDecay( void ){
   delete[] lastDecayval_;
 }
 
+void FieldMeterDecay::checkResources( void ){
+  FieldMeter::checkResources();
+  halfLife_ = atof(parent_->getResourceOrUseDefault("decayHalfLife", "2.3"));
+}
+
+void FieldMeterDecay::useDecay( const char *resource ){
+  char name[128];
+
+  dodecay_ = parent_->isResourceTrue(resource);
+  snprintf(name, sizeof(name), "%sHalfLife", resource);
+  const char *halflife = parent_->getResourceOrUseDefault(name, NULL);
+  if (halflife)
+    halfLife_ = atof(halflife);
+}
+
+//  Moves the average towards the latest values by as much as the time
+//  since the last ones calls for: after halfLife_ seconds, an old value
+//  counts for half of what it did.  It is only done when latch() has
+//  brought new values, so redraws (expose, resize) leave it alone and
+//  it does not depend on how often the meter is drawn.
+void FieldMeterDecay::decay( void ){
+  unsigned long long now = Timer::nsecs();
+
+  if (firsttime_) {
+    firsttime_ = 0;
+    for (int i = 0 ; i < numfields_ ; i++)
+      decay_[i] = shownfields_[i] / showntotal_;
+  }
+  else {
+    double dt = (now - lastDecay_) / 1e9;
+    double a = halfLife_ > 0 ? exp2(-dt / halfLife_) : 0;
+    double b = (1 - a) / showntotal_;
+    const double *fields = shownfields_;
+    double *decay = decay_;
+    for (int i = 0 ; i < numfields_ ; i++)
+      decay[i] = a * decay[i] + b * fields[i];
+  }
+  lastDecay_ = now;
+  decayed_ = latches_;
+}
+
 void FieldMeterDecay::drawfields( int mandatory ){
   int twidth, x = x_;
   int decay_changed = 0;
@@ -58,36 +107,21 @@ void FieldMeterDecay::drawfields( int mandatory ){
     return;
   }
 
-  if ( total_ == 0.0 )
+  if ( !threaded_ )
+    latch();
+  if ( showntotal_ == 0.0 )
     return;
 
   int halfheight = height_ / 2;
   int decaytwidth, decayx = x_;
 
-  //  This code is supposed to make the average display look just like
-  //  the ordinary display for the first drawfields, but it doesn't seem
-  //  to work too well.  But it's better than setting all decay_ fields
-  //  to 0.0 initially!
-
-  if (firsttime_) {
-    firsttime_ = 0;
+  //  The first time, the average starts out as the values themselves.
+  //  Markers that moved leave the top half to be drawn over again.
+  if (firsttime_ || placeOverlay(width_))
     mandatory = 1;
-    for (int i = 0; i < numfields_; i++)
-         {
-                decay_[i] = 1.0*fields_[i]/total_;
-         }
-  }
-
-  //  Update the decay fields.  This is not quite accurate, since if
-  //  the screen is refreshed, we will update the decay fields more
-  //  often than we need to.  However, this makes the decay stuff
-  //  TOTALLY independent of the ????Meter methods.
-
-  //  The constant below can be modified for quicker or slower
-  //  exponential rates for the average.  No fancy math is done to
-  //  set it to correspond to a five-second decay or anything -- I
-  //  just played with it until I thought it looked good!  :)  BCG
-#define ALPHA 0.97
+  bool drew = false;
+  if (firsttime_ || latches_ != decayed_)
+    decay();
 
     /*  This is majorly ugly code.  It needs a rewrite.  BCG  */
     /*  I think one good way to do it may be to normalize all of the
@@ -99,10 +133,8 @@ void FieldMeterDecay::drawfields( int mandatory ){
      *  lot of places.  BCG */
   for ( int i = 0 ; i < numfields_ ; i++ ){
 
-    decay_[i] = ALPHA*decay_[i] + (1-ALPHA)*(fields_[i]*1.0/total_);
-
     //  We want to round the widths, rather than truncate.
-    twidth = (int) (0.5 + (width_ * (double) fields_[i]) / total_);
+    twidth = (int) (0.5 + (width_ * (double) shownfields_[i]) / showntotal_);
     decaytwidth = (int) (0.5 + width_ * decay_[i]);
     if (decaytwidth < 0.0) {
         std::cerr << "Error:  FieldMeterDecay " << name() << ":  decaytwidth of ";
@@ -124,35 +156,36 @@ void FieldMeterDecay::drawfields( int mandatory ){
     if ( (i == numfields_ - 1) && ((decayx + decaytwidth) != (x_ + width_)))
       decaytwidth = width_ + x_ - decayx;
 
-    parent_->setForeground( colors_[i] );
-    parent_->setStippleN(i%4);
-
-    //  drawFilledRectangle() adds one to its width and height.
-    //    Let's correct for that here.
+    //  fillRectangle() adds one to its width and height, so each
+    //  field but the last leaves its right edge to the next one.
+    int last = (i == numfields_ - 1);
     if ( mandatory || (twidth != lastvals_[i]) || (x != lastx_[i]) ){
       if (!checkX(x, twidth))
         std::cerr <<__FILE__ << ":" << __LINE__ <<std::endl;
-      parent_->drawFilledRectangle( x, y_, twidth, halfheight );
+      parent_->fillRectangle( colors_[i], i%4, x, y_, twidth - !last,
+                              halfheight );
+      drew = true;
     }
 
     if ( mandatory || decay_changed || (decay_[i] != lastDecayval_[i]) ){
       if (!checkX(decayx, decaytwidth))
         std::cerr <<__FILE__ << ":" << __LINE__ <<std::endl;
       decay_changed = 1;
-      parent_->drawFilledRectangle( decayx, y_+halfheight+1,
-            decaytwidth, height_ - halfheight-1);
+      parent_->fillRectangle( colors_[i], i%4, decayx, y_+halfheight+1,
+            decaytwidth - !last, height_ - halfheight-1);
     }
 
     lastvals_[i] = twidth;
     lastx_[i] = x;
     lastDecayval_[i] = decay_[i];
 
-    parent_->setStippleN(0);	/*  Restore all-bits stipple.  */
-    if ( dousedlegends_ )
-      drawused( mandatory );
     x += twidth;
 
     decayx += decaytwidth;
 
   }
+  if ( drew )
+    drawOverlay( halfheight );
+  if ( dousedlegends_ )
+    drawused( mandatory );
 }
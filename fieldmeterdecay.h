@@ -28,13 +28,24 @@ public:
   virtual ~FieldMeterDecay( void );
 
   virtual void drawfields( int mandatory = 0 );
+  virtual void checkResources( void );
 
 protected:
   int dodecay_;
   int firsttime_;  //  Used to set up decaying fields right the first time.
   double *decay_;
   double *lastDecayval_;
+
+  //  Sets dodecay_ from the resource (e.g. cpuDecay), and the half-life
+  //  from <resource>HalfLife when that is set.
+  void useDecay( const char *resource );
+
 private:
+  double halfLife_;                 //  secs
+  unsigned long decayed_;           //  latches_ as of the last update
+  unsigned long long lastDecay_;    //  nsecs on Timer's clock
+
+  void decay( void );
 };
 
 #endif
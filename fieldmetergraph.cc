@@ -23,7 +23,11 @@
 //       useGraph_ variable according to the, e.g., xosview*cpuGraph resource.
 
 #include "fieldmetergraph.h"
+#include "raster.h"
+#include "history.h"
+#include "timer.h"
 #include <stdio.h>
+#include <string.h>
 
 
 FieldMeterGraph::FieldMeterGraph( XOSView *parent,
@@ -35,6 +39,13 @@ FieldMeterGraph::FieldMeterGraph( XOSView *parent,
 {
 
 	useGraph_ = 0;
+	useImage_ = 0;
+	raster_ = NULL;
+	history_ = NULL;
+	historyLatches_ = 0;
+	viewZoom_ = viewBack_ = 0;
+	viewVersion_ = 0;
+	histcolumn_ = NULL;
 	heightfield_ = NULL;
 	lastWinState = XOSView::OBSCURED;
 
@@ -47,6 +58,9 @@ FieldMeterGraph::FieldMeterGraph( XOSView *parent,
 FieldMeterGraph::~FieldMeterGraph( void )
 {
 	delete [] heightfield_;
+	delete raster_;
+	delete history_;
+	delete [] histcolumn_;
 }
 
 void FieldMeterGraph::drawfields( int mandatory )
@@ -62,7 +76,9 @@ void FieldMeterGraph::drawfields( int mandatory )
 		return;
 	}
 
-	if( total_ <= 0.0 )
+	if( !threaded_ )
+		latch();
+	if( showntotal_ <= 0.0 )
 		return;
 
 	// allocate memory for height field graph storage
@@ -72,49 +88,88 @@ void FieldMeterGraph::drawfields( int mandatory )
 	{
 		if( numfields_ > 0 && graphNumCols_ > 0 )
 		{
-			heightfield_ = new double [numfields_*graphNumCols_];
+			heightfield_ = new unsigned short [numfields_*graphNumCols_];
 
 			for( i = 0; i < graphNumCols_; i++ )
 			{
 				for( j = 0; j < numfields_; j++ )
 				{
 					if( j < numfields_-1 )
-						heightfield_[i*numfields_+j] = 0.0;
+						heightfield_[i*numfields_+j] = 0;
 					else
-						heightfield_[i*numfields_+j] = 1.0;
+						heightfield_[i*numfields_+j] = HEIGHT_ONE;
 				}
 			}
 		}
 	}
 
-	// check current position here and slide graph if necessary
-	if( graphpos_ >= graphNumCols_ )
-	{
-		for( i = 0; i < graphNumCols_-1; i++ )
-		{
-			for( j = 0; j < numfields_; j++ )
-			{
-				heightfield_[i*numfields_+j] = heightfield_[(i+1)*numfields_+j];
-			}
-		}
-		graphpos_ = graphNumCols_ - 1;
-	}
+	// A sample taken after a stretch of slowed down sampling (see
+	// obscuredSampleDivisor) covers several columns.  They all get the
+	// sample, which for the rate meters is the average over all of them.
+	int ncols = shownperiods_;
+	if( ncols > graphNumCols_ )
+		ncols = graphNumCols_;
 
 	// get current values to be plotted
+	unsigned short *column = heightfield_ + graphpos_*numfields_;
 	for( i = 0; i < numfields_; i++ )
 	{
-		double a = fields_[i] / total_;
+		double a = shownfields_[i] / showntotal_;
 		if( a <= 0.0 )
 			a = 0.0;
 		if( a >= 1.0 )
 			a = 1.0;
-		heightfield_[graphpos_*numfields_+i] = a;
+		column[i] = (unsigned short)(a*HEIGHT_ONE + 0.5);
+	}
+
+	// new values also go into the history, once
+	if( !history_ && !parent_->historyTiers().empty() )
+	{
+		history_ = new History( numfields_, parent_->historyTiers() );
+		histcolumn_ = new unsigned short [numfields_];
+	}
+	if( history_ && latches_ != historyLatches_ )
+	{
+		history_->add( column, Timer::nsecs() );
+		historyLatches_ = latches_;
+	}
+
+	// the new column replaces the oldest one, which moves the graph
+	// along by one column
+	for( int n = 0; n < ncols; n++ )
+	{
+		int pos = graphpos_;
+		if( ++graphpos_ >= graphNumCols_ )
+			graphpos_ = 0;
+		if( n < ncols-1 )
+			memcpy( heightfield_ + graphpos_*numfields_,
+				heightfield_ + pos*numfields_,
+				numfields_*sizeof(*heightfield_) );
 	}
 
 	currWinState = parent_->getWindowVisibilityState();
 
-	// Try to avoid having to redraw everything.
-	if (!mandatory && currWinState == XOSView::FULLY_VISIBLE && currWinState == lastWinState)
+	// Looking back through the history, or just back from doing so.
+	if( history_ && parent_->historyZoom() > 0 )
+	{
+		drawHistory( mandatory );
+		lastWinState = currWinState;
+		if ( dousedlegends_ )
+			drawused( mandatory );
+		return;
+	}
+	if( viewZoom_ )
+		mandatory = 1;
+	viewZoom_ = 0;
+
+	// Lines that moved would otherwise scroll along with the graph.
+	if( placeOverlay( height_ ) )
+		mandatory = 1;
+
+	// Try to avoid having to redraw everything.  On a remote display
+	// a scroll by several columns is still cheaper than a redraw.
+	if (!mandatory && (ncols == 1 || (parent_->remote() && ncols < graphNumCols_))
+	    && currWinState == XOSView::FULLY_VISIBLE && currWinState == lastWinState)
 	{
 		// scroll area
 		int col_width = width_/graphNumCols_;
@@ -123,22 +178,37 @@ void FieldMeterGraph::drawfields( int mandatory )
 			col_width = 1;
 		}
 
-		int sx = x_ + col_width;
-		int swidth = width_ - col_width;
+		int sx = x_ + ncols*col_width;
+		int swidth = width_ - ncols*col_width;
 		int sheight = height_ + 1;
 		if( sx > x_ && swidth > 0 && sheight > 0 )
 			parent_->copyArea( sx, y_, swidth, sheight, x_, y_ );
-		drawBar( graphNumCols_ - 1 );
+		for( i = graphNumCols_ - ncols; i < graphNumCols_; i++ )
+			drawBar( i, liveColumn( i ) );
 	} else {
-		// need to draw entire graph for some reason
+		// need to draw entire graph for some reason.  With graphImage
+		// set the bars go into an image of the graph, which is sent
+		// to the X server in one go.  Stipples are not done there.
+		if( useImage_ && !raster_ && !parent_->stippling() )
+			raster_ = new Raster( parent_ );
+		Raster *raster = NULL;
+		if( raster_ && raster_->size( width_+1, height_+1 ) )
+		{
+			raster = raster_;
+			raster->fillRectangle( parent_->background(), 0, 0,
+					       width_, height_ );
+		}
+
 		for( i = 0; i < graphNumCols_; i++ ) {
-			drawBar( i );
+			drawBar( i, liveColumn( i ), raster );
 		}
+
+		if( raster )
+			raster->put( x_, y_ );
 	}
+	drawOverlayLines();
 
 	lastWinState = currWinState;
-	graphpos_++;
-	parent_->setStippleN(0);	//  Restore all-bits stipple.
 	if ( dousedlegends_ )
 	{
 		drawused( mandatory );
@@ -146,13 +216,83 @@ void FieldMeterGraph::drawfields( int mandatory )
 }
 
 
-void FieldMeterGraph::drawBar( int i )
+// The graph from the averages of a history tier, its newest column
+// (historyBack() back) on the right.  Columns with no samples are left
+// empty.  It is only drawn again when it changes.
+void FieldMeterGraph::drawHistory( int mandatory )
+{
+	int tier = parent_->historyZoom() - 1;
+	int back = parent_->historyBack();
+
+	if( tier >= history_->tiers() )
+		tier = history_->tiers() - 1;
+	if( !mandatory && tier + 1 == viewZoom_ && back == viewBack_
+	    && history_->version() == viewVersion_ )
+		return;
+	viewZoom_ = tier + 1;
+	viewBack_ = back;
+	viewVersion_ = history_->version();
+
+	if( useImage_ && !raster_ && !parent_->stippling() )
+		raster_ = new Raster( parent_ );
+	Raster *raster = NULL;
+	if( raster_ && raster_->size( width_+1, height_+1 ) )
+	{
+		raster = raster_;
+		raster->fillRectangle( parent_->background(), 0, 0,
+				       width_, height_ );
+	}
+	else
+		parent_->clear( x_, y_, width_+1, height_+1 );
+
+	for( int i = 0; i < graphNumCols_; i++ )
+	{
+		int b = back + graphNumCols_-1 - i;
+		bool filled = true;
+		for( int j = 0; j < numfields_ && filled; j++ )
+			filled = history_->get( tier, b, j, NULL,
+						&histcolumn_[j], NULL );
+		if( filled )
+			drawBar( i, histcolumn_, raster );
+	}
+
+	if( raster )
+		raster->put( x_, y_ );
+}
+
+// The peak and 95th percentile as lines across the graph, at the
+// height the used fields would reach.
+void FieldMeterGraph::drawOverlayLines( void )
+{
+	if( p95pos_ >= 0 )
+	{
+		parent_->setForeground( p95color_ );
+		parent_->drawLine( x_, y_ + height_ - p95pos_,
+				   x_ + width_, y_ + height_ - p95pos_ );
+	}
+	if( peakpos_ >= 0 )
+	{
+		parent_->setForeground( peakcolor_ );
+		parent_->drawLine( x_, y_ + height_ - peakpos_,
+				   x_ + width_, y_ + height_ - peakpos_ );
+	}
+}
+
+void FieldMeterGraph::drawBar( int i, const unsigned short *column,
+			       Raster *raster )
 {
 	int j;
 	int y = y_ + height_;
 	int x = x_ + i*width_/graphNumCols_;
 	int barwidth = (x_ + (i+1)*width_/graphNumCols_)-x;
 
+	// fillRectangle() adds one to the width and height.  The bars are
+	// queued together and must not overlap, so each column but the last
+	// leaves its right edge to the next one, and each field leaves its
+	// top row to the one stacked on it (pending until that is known).
+	int w = barwidth - ( i < graphNumCols_-1 );
+	int pending = -1, pendingy = 0, pendingheight = 0;
+
 	if( barwidth>0 )
 	{
 		int barheight;
@@ -160,10 +300,7 @@ void FieldMeterGraph::drawBar( int i )
 		{
 			/*  Round up, by adding 0.5 before
 			*  converting to an int.  */
-			barheight = (int)((heightfield_[i*numfields_+j]*height_)+0.5);
-
-			parent_->setForeground( colors_[j] );
-			parent_->setStippleN(j%4);
+			barheight = (int)((column[j]*(double)height_/HEIGHT_ONE)+0.5);
 
 			if( barheight > (y-y_) )
 				barheight = (y-y_);
@@ -174,14 +311,34 @@ void FieldMeterGraph::drawBar( int i )
 
 			y -= barheight;
 			if( barheight>0 )
-				parent_->drawFilledRectangle( x, y, barwidth, barheight );
+			{
+				if( pending >= 0 )
+					fillBar( raster, pending,
+						 x, pendingy+1, w, pendingheight-1 );
+				pending = j;
+				pendingy = y;
+				pendingheight = barheight;
+			}
 		}
+		if( pending >= 0 )
+			fillBar( raster, pending, x, pendingy, w, pendingheight );
 	}
 }
+
+void FieldMeterGraph::fillBar( Raster *raster, int field,
+			       int x, int y, int w, int h )
+{
+	if( raster )
+		raster->fillRectangle( colors_[field], x - x_, y - y_, w, h );
+	else
+		parent_->fillRectangle( colors_[field], field%4, x, y, w, h );
+}
 void FieldMeterGraph::checkResources( void )
 {
   FieldMeterDecay::checkResources();
 
+  useImage_ = parent_->isResourceTrue( "graphImage" );
+
   const char *ptr = parent_->getResource( "graphNumCols" );
   if( ptr )
   {
@@ -198,10 +355,14 @@ void FieldMeterGraph::checkResources( void )
 void FieldMeterGraph::setNumCols( int n )
 {
 	graphNumCols_ = n;
-	graphpos_ = graphNumCols_-1;
+	graphpos_ = 0;
 
 	if( heightfield_ )
 		delete [] heightfield_;
 	heightfield_ = NULL;
+	delete history_;
+	history_ = NULL;
+	delete [] histcolumn_;
+	histcolumn_ = NULL;
 
 }
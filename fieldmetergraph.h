@@ -15,6 +15,8 @@
 #include "fieldmeterdecay.h"
 #include "xosview.h"
 
+class Raster;
+class History;
 
 class FieldMeterGraph : public FieldMeterDecay {
 public:
@@ -30,15 +32,35 @@ public:
 protected:
   void setNumCols( int n );
 
+  //  heightfield_ holds graphNumCols_ columns of numfields_ fractions
+  //  of the graph height each, in units of 1/HEIGHT_ONE.  It is a ring:
+  //  graphpos_ is where the oldest column is, and where the next sample
+  //  goes.
+  enum { HEIGHT_ONE = 65535 };
+
   int useGraph_;
+  int useImage_;        // full redraws go through raster_ (graphImage)
+  Raster *raster_;
   int graphNumCols_;
   int graphpos_;
+  //  Samples kept for scrolling back (see XOSView::historyZoom()), and
+  //  the part of it last drawn.
+  History *history_;
+  unsigned long historyLatches_;
+  int viewZoom_, viewBack_;
+  unsigned long viewVersion_;
+  unsigned short *histcolumn_;
   /*  There's some sort of corruption going on -- we can't have
    *  variables after the heightfield_ below, otherwise they get
    *  corrupted???  */
-  double *heightfield_;
+  unsigned short *heightfield_;
 private:
-  void drawBar( int i );
+  void drawBar( int i, const unsigned short *column, Raster *raster = NULL );
+  const unsigned short *liveColumn( int i ) const
+    { return heightfield_ + ((graphpos_ + i) % graphNumCols_)*numfields_; }
+  void drawHistory( int mandatory );
+  void drawOverlayLines( void );
+  void fillBar( Raster *raster, int field, int x, int y, int w, int h );
   enum XOSView::windowVisibilityState lastWinState;
 };
 
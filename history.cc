@@ -0,0 +1,151 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#include "history.h"
+#include <stdlib.h>
+
+
+bool History::parse( const char *spec, std::vector<Tier> &tiers ){
+  tiers.clear();
+  while (*spec) {
+    char *end;
+    double secs = strtod(spec, &end);
+    if (end == spec || (*end != 'x' && *end != 'X') || secs <= 0)
+      return false;
+    long cols = strtol(end + 1, &end, 10);
+    if (cols <= 0)
+      return false;
+
+    Tier t;
+    t.nsecs = (unsigned long long)(secs * 1e9);
+    t.cols = cols;
+    tiers.push_back(t);
+
+    while (*end == ' ' || *end == '\t' || *end == ',')
+      end++;
+    spec = end;
+  }
+  return true;
+}
+
+History::History( int numfields, const std::vector<Tier> &tiers )
+  : numfields_(numfields), tiers_(tiers.size()), version_(0) {
+  for (unsigned int t = 0 ; t < tiers.size() ; t++) {
+    Level &l = tiers_[t];
+    l.tier = tiers[t];
+    l.head = l.count = 0;
+    l.bucket = 0;
+    l.n = 0;
+    l.sum.resize(numfields_);
+    l.min.resize(numfields_);
+    l.max.resize(numfields_);
+  }
+}
+
+History::~History( void ){
+}
+
+void History::add( const unsigned short *values, unsigned long long when ){
+  for (unsigned int t = 0 ; t < tiers_.size() ; t++) {
+    Level &l = tiers_[t];
+    unsigned long long bucket = when / l.tier.nsecs;
+
+    if (l.n && bucket != l.bucket) {
+      complete(l, true);
+      //  Columns that no sample fell in, at most a whole tier of them.
+      unsigned long long skipped = bucket - l.bucket - 1;
+      if (bucket < l.bucket)
+        skipped = 0;
+      if (skipped > (unsigned long long)l.tier.cols)
+        skipped = l.tier.cols;
+      for ( ; skipped ; skipped--)
+        complete(l, false);
+    }
+
+    if (!l.n) {
+      l.bucket = bucket;
+      for (int i = 0 ; i < numfields_ ; i++) {
+        l.sum[i] = values[i];
+        l.min[i] = l.max[i] = values[i];
+      }
+    }
+    else {
+      double *sum = &l.sum[0];
+      unsigned short *min = &l.min[0], *max = &l.max[0];
+      for (int i = 0 ; i < numfields_ ; i++) {
+        unsigned short v = values[i];
+        sum[i] += v;
+        if (v < min[i])
+          min[i] = v;
+        if (v > max[i])
+          max[i] = v;
+      }
+    }
+    l.n++;
+  }
+}
+
+void History::complete( Level &l, bool filled ){
+  int cols = l.tier.cols, head = l.head;
+
+  if (head == (int)l.filled.size())
+    grow(l);
+  l.filled[head] = filled;
+  if (filled)
+    for (int i = 0 ; i < numfields_ ; i++) {
+      int at = head * numfields_ + i;
+      l.values[MIN][at] = l.min[i];
+      l.values[AVG][at] = (unsigned short)(l.sum[i] / l.n + 0.5);
+      l.values[MAX][at] = l.max[i];
+    }
+  l.n = 0;
+  if (++l.head >= cols)
+    l.head = 0;
+  if (l.count < cols)
+    l.count++;
+  version_++;
+}
+
+//  Adds a column to a tier that is not full yet.  The room for them is
+//  doubled as needed, but never beyond the tier, which would take more
+//  than allocating it all up front.
+void History::grow( Level &l ){
+  unsigned int size = (l.filled.size() + 1) * numfields_;
+
+  if (size > l.values[MIN].capacity()) {
+    unsigned int room = 2 * l.values[MIN].capacity();
+    if (room < 64 * (unsigned int)numfields_)
+      room = 64 * numfields_;
+    if (room > (unsigned int)l.tier.cols * numfields_)
+      room = l.tier.cols * numfields_;
+    for (int k = MIN ; k <= MAX ; k++)
+      l.values[k].reserve(room);
+  }
+  for (int k = MIN ; k <= MAX ; k++)
+    l.values[k].resize(size);
+  l.filled.push_back(false);
+}
+
+bool History::get( int t, int back, int field, unsigned short *min,
+                   unsigned short *avg, unsigned short *max ) const {
+  const Level &l = tiers_[t];
+  if (back < 0 || back >= l.count)
+    return false;
+
+  int cols = l.tier.cols;
+  int column = (l.head - 1 - back + cols) % cols;
+  if (!l.filled[column])
+    return false;
+
+  int i = column * numfields_ + field;
+  if (min)
+    *min = l.values[MIN][i];
+  if (avg)
+    *avg = l.values[AVG][i];
+  if (max)
+    *max = l.values[MAX][i];
+  return true;
+}
@@ -0,0 +1,85 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _HISTORY_H_
+#define _HISTORY_H_
+
+//
+//  What a graph showed, kept for longer than the graph is wide, in tiers
+//  of fixed size and resolution (by default a second for 10 minutes and
+//  10 seconds for 6 hours; see historyTiers).  Each
+//  tier averages the samples that fall in each of its columns on its own,
+//  so add() costs the same however long the history is, and keeps the
+//  minimum, average and maximum of each field.  The values are fractions
+//  of the graph height in units of 1/ONE, as in FieldMeterGraph.
+//
+//  The columns of a tier are kept as a ring, one array of columns of
+//  all fields for each of min, avg and max.  The ring grows a column at
+//  a time until the tier is full, so a coarse tier that is hours from
+//  filling up takes no more memory than what it has seen.  Columns no
+//  sample fell in (while xosview was stopped, say) are kept as empty.
+//
+
+#include <vector>
+
+
+class History {
+public:
+  enum { ONE = 65535 };
+  enum Kind { MIN, AVG, MAX };
+
+  struct Tier {
+    unsigned long long nsecs;  //  per column
+    int cols;
+  };
+
+  //  Reads tiers from "secs x columns ...", e.g. "1x600 10x2160".
+  static bool parse( const char *spec, std::vector<Tier> &tiers );
+
+  History( int numfields, const std::vector<Tier> &tiers );
+  ~History( void );
+
+  //  A sample of numfields values taken at when (nsecs on Timer's clock).
+  void add( const unsigned short *values, unsigned long long when );
+
+  int tiers( void ) const { return tiers_.size(); }
+  const Tier &tier( int t ) const { return tiers_[t].tier; }
+  //  Goes up whenever a column is completed.
+  unsigned long version( void ) const { return version_; }
+
+  //  The values of field in the column back columns before the newest
+  //  complete one of tier t.  False if there is no such column, or no
+  //  sample fell in it.
+  bool get( int t, int back, int field, unsigned short *min,
+            unsigned short *avg, unsigned short *max ) const;
+
+private:
+  struct Level {
+    Tier tier;
+    //  [column * numfields + field], for as many columns as filled
+    std::vector<unsigned short> values[3];
+    std::vector<bool> filled;
+    int head;              //  where the next column goes
+    int count;             //  complete columns, up to cols
+    //  The column being filled.
+    unsigned long long bucket;
+    int n;
+    std::vector<double> sum;
+    std::vector<unsigned short> min, max;
+  };
+
+  int numfields_;
+  std::vector<Level> tiers_;
+  unsigned long version_;
+
+  void complete( Level &l, bool filled );
+  void grow( Level &l );
+
+  History( const History & );
+  History &operator=( const History & );
+};
+
+#endif
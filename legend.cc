@@ -0,0 +1,61 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#include "legend.h"
+#include "xwin.h"
+
+
+void Legend::set( const char *legend ){
+  tokens_.clear();
+  measured_ = false;
+
+  Token token;
+  token.x = 0;
+  for ( const char *cur = legend ; ; cur++ ){
+    if ( *cur == '\\' && cur[1] == '/' )  //  allow '/' in field as '\/'
+      token.text += *++cur;
+    else if ( *cur == '/' || *cur == '\0' ){
+      tokens_.push_back( token );
+      token.text.clear();
+      if ( *cur == '\0' )
+        break;
+    }
+    else
+      token.text += *cur;
+  }
+}
+
+void Legend::measure( XWin *win ){
+  int x = 0;
+
+  slashWidth_ = win->textWidth( "/", 1 );
+  for ( unsigned int i = 0 ; i < tokens_.size() ; i++ ){
+    tokens_[i].x = x;
+    x += win->textWidth( tokens_[i].text.c_str(), tokens_[i].text.size() )
+      + slashWidth_;
+  }
+  measured_ = true;
+}
+
+void Legend::draw( XWin *win, int x, int y, const unsigned long *colors,
+                   int nfields ){
+  if ( !measured_ )
+    measure( win );
+  if ( nfields > fields() )
+    nfields = fields();
+
+  for ( int i = 0 ; i < nfields ; i++ ){
+    win->setStippleN( i%4 );
+    win->setForeground( colors[i] );
+    win->drawString( x + tokens_[i].x, y, tokens_[i].text.c_str() );
+  }
+
+  //  The slashes all go in the one color.
+  win->setStippleN( 0 );  /*  Restore default all-bits stipple.  */
+  win->setForeground( win->foreground() );
+  for ( int i = 0 ; i < nfields - 1 ; i++ )
+    win->drawString( x + tokens_[i + 1].x - slashWidth_, y, "/" );
+}
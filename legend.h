@@ -0,0 +1,46 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _LEGEND_H_
+#define _LEGEND_H_
+
+#include <string>
+#include <vector>
+
+class XWin;
+
+//
+//  A field legend such as "USED/CACHE/FREE", split at the slashes ("\/"
+//  is a slash within a field) once when it is set.  The width of each
+//  field is measured on the first draw(), since the font may not be
+//  loaded when the legend is set, and kept as long as the legend is.
+//
+class Legend {
+public:
+  Legend( void ) : slashWidth_(0), measured_(false) {}
+
+  void set( const char *legend );
+  int fields( void ) const { return tokens_.size(); }
+  const std::string &field( int i ) const { return tokens_[i].text; }
+
+  //  Draws the first nfields fields from (x, y), each in its color and
+  //  stipple, separated by slashes in the foreground color.
+  void draw( XWin *win, int x, int y, const unsigned long *colors,
+             int nfields );
+
+private:
+  struct Token {
+    std::string text;
+    int x;              //  offset from the start of the legend
+  };
+  std::vector<Token> tokens_;
+  int slashWidth_;
+  bool measured_;
+
+  void measure( XWin *win );
+};
+
+#endif
@@ -26,6 +26,7 @@
 #endif
 #include "lmstemp.h"
 #include "acpitemp.h"
+#include "procfile.h"
 
 #include <string.h>
 #include <stdlib.h>
@@ -41,6 +42,9 @@ MeterMaker::MeterMaker(XOSView *xos){
 }
 
 void MeterMaker::makeMeters(void){
+  // count /proc and /sys reads per tick for XOSDEBUG
+  ProcFile::tickSource(_xos);
+
   // check for the load meter
   if (_xos->isResourceTrue("load"))
     push(new LoadMeter(_xos));
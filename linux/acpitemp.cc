@@ -16,9 +16,7 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <dirent.h>
-#include <fstream>
 #include <iostream>
-#include <string>
 
 static const char PROC_ACPI_TZ[] = "/proc/acpi/thermal_zone";
 static const char SYS_ACPI_TZ[]  = "/sys/devices/virtual/thermal";
@@ -66,8 +64,8 @@ int ACPITemp::checkacpi( const char *tempfile, const char *highfile ) {
   }
 
   if (temp_found && high_found) {
-    strncpy(_tempfile, tempfile, PATH_SIZE);
-    strncpy(_highfile, highfile, PATH_SIZE);
+    _tempfile.filename(tempfile);
+    _highfile.filename(highfile);
     return true;
   }
 
@@ -76,8 +74,8 @@ int ACPITemp::checkacpi( const char *tempfile, const char *highfile ) {
 
   if ( (stat(temp, &buf) == 0 && S_ISREG(buf.st_mode)) &&
        (stat(high, &buf) == 0 && S_ISREG(buf.st_mode)) ) {
-    strncpy(_tempfile, temp, PATH_SIZE);
-    strncpy(_highfile, high, PATH_SIZE);
+    _tempfile.filename(temp);
+    _highfile.filename(high);
     _usesysfs = true;
     return true;
   }
@@ -88,8 +86,8 @@ int ACPITemp::checkacpi( const char *tempfile, const char *highfile ) {
 
   if ( (stat(temp, &buf) == 0 && S_ISREG(buf.st_mode)) &&
        (stat(high, &buf) == 0 && S_ISREG(buf.st_mode)) ) {
-    strncpy(_tempfile, temp, PATH_SIZE);
-    strncpy(_highfile, high, PATH_SIZE);
+    _tempfile.filename(temp);
+    _highfile.filename(high);
     return true;
   }
   return false;
@@ -114,33 +112,30 @@ void ACPITemp::checkevent( void ) {
 }
 
 void ACPITemp::getacpitemp( void ) {
-  std::ifstream temp_file(_tempfile);
-  std::ifstream high_file(_highfile);
+  const char *temp_buf = _tempfile.read();
+  const char *high_buf = _highfile.read();
 
-  if (!temp_file) {
-    std::cerr << "Can not open file : " << temp_file << std::endl;
+  if (!temp_buf) {
+    std::cerr << "Can not open file : " << _tempfile.filename() << std::endl;
     parent_->done(1);
     return;
   }
-  if (!high_file) {
-    std::cerr << "Can not open file : " << high_file << std::endl;
+  if (!high_buf) {
+    std::cerr << "Can not open file : " << _highfile.filename() << std::endl;
     parent_->done(1);
     return;
   }
 
-  float high;
-  std::string dummy;
+  float high = 0;
   bool do_legend = false;
 
   if (_usesysfs) {
-    high_file >> high;
-    high /= 1000.0;
-    temp_file >> fields_[0];
-    fields_[0] /= 1000.0;
+    high = strtod(high_buf, NULL) / 1000.0;
+    fields_[0] = strtod(temp_buf, NULL) / 1000.0;
   }
   else {
-    high_file >> dummy >> dummy >> high;
-    temp_file >> dummy >> fields_[0];
+    sscanf(high_buf, "%*s %*s %f", &high);
+    sscanf(temp_buf, "%*s %lf", &fields_[0]);
   }
 
   if (high > total_ || high != _high) {
@@ -14,6 +14,7 @@
 
 #include "fieldmeter.h"
 #include "xosview.h"
+#include "procfile.h"
 
 #define PATH_SIZE 128
 
@@ -32,8 +33,8 @@ protected:
   void getacpitemp( void );
   int  checkacpi(const char* tempfile, const char* highfile);
 private:
-  char _tempfile[PATH_SIZE];
-  char _highfile[PATH_SIZE];
+  ProcFile _tempfile;
+  ProcFile _highfile;
   int  _high;
   bool _usesysfs;
   unsigned long _actcolor, _highcolor;
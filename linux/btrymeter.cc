@@ -14,18 +14,37 @@
 #include <dirent.h>
 #include <string.h>
 #include <errno.h>
+#include <ctype.h>
 #include <fstream>
 #include <string>
 #include <iostream>
-#include <sstream>
 
 static const char APMFILENAME[] = "/proc/apm";
 static const char ACPIBATTERYDIR[] = "/proc/acpi/battery";
 static const char SYSPOWERDIR[] = "/sys/class/power_supply";
 
+// The value after "name:" in the ACPI "name:   value" files, or NULL.
+static const char *acpivalue( const char *buf, const char *name ){
+  int len = strlen(name);
+  while ( buf && *buf ) {
+    if ( !strncmp(buf, name, len) && buf[len] == ':' )
+      return buf + len + 1 + strspn(buf + len + 1, " \t");
+    if ( (buf = strchr(buf, '\n')) )
+      buf++;
+  }
+  return NULL;
+}
+
+// Is the first word of s equal to word ?
+static bool isword( const char *s, const char *word ){
+  int len = strlen(word);
+  return s && !strncmp(s, word, len) && (!s[len] || isspace(s[len]));
+}
+
 
 BtryMeter::BtryMeter( XOSView *parent )
-  : FieldMeter( parent, 2, "BTRY", "CHRG/USED", 1, 1, 0 ){
+  : FieldMeter( parent, 2, "BTRY", "CHRG/USED", 1, 1, 0 ),
+  _apmfile(APMFILENAME) {
 
   // find out ONCE whether to use ACPI, APM or sysfs
   use_acpi = use_apm = use_syspower = false;
@@ -39,12 +58,25 @@ BtryMeter::BtryMeter( XOSView *parent )
       use_acpi=false; use_apm=false; use_syspower=true;
   }
 
-  old_apm_battery_state = apm_battery_state = 0xFF;
-  old_acpi_charge_state = acpi_charge_state = -2;
+  apm_battery_state = 0xFF;
+  acpi_charge_state = -2;
+  state_ = shownstate_ = _drawnstate = currentstate();
 
 }
 
 BtryMeter::~BtryMeter( void ){
+  for (std::map<std::string, ProcFile *>::iterator it = _files.begin();
+       it != _files.end(); ++it)
+    delete it->second;
+}
+
+// Batteries come and go, so keep one ProcFile for every file ever
+// looked at.  Returns NULL if the file is not there (right now).
+const char *BtryMeter::readfile( const std::string& filename ){
+  ProcFile *&file = _files[filename];
+  if (!file)
+    file = new ProcFile(filename.c_str());
+  return file->read();
 }
 
 // determine if any usable source of battery information
@@ -155,8 +187,8 @@ void BtryMeter::checkResources( void ){
   SetUsedFormat(parent_->getResource( "batteryUsedFormat" ) );
 }
 
-void BtryMeter::handle_apm_state( void ){
-  switch ( apm_battery_state ) {
+void BtryMeter::handle_apm_state( int state ){
+  switch ( state ) {
   case 0: /* high (e.g. over 25% on my box) */
     XOSDEBUG("battery_status HIGH\n");
     setfieldcolor( 0, parent_->getResource("batteryLeftColor"));
@@ -198,8 +230,8 @@ void BtryMeter::handle_apm_state( void ){
   }
 }
 
-void BtryMeter::handle_acpi_state( void ){
-  switch ( acpi_charge_state ) {
+void BtryMeter::handle_acpi_state( int state ){
+  switch ( state ) {
   case 0:  // charged
     XOSDEBUG("battery_status CHARGED\n");
     setfieldcolor( 0, parent_->getResource("batteryFullColor"));
@@ -232,24 +264,30 @@ void BtryMeter::handle_acpi_state( void ){
   }
 }
 
+void BtryMeter::sample( void ){
+  getpwrinfo();
+  state_ = currentstate();
+}
+
+//  Only one of the two states ever changes, depending on the source.
+int BtryMeter::currentstate( void ) const {
+  return ( use_apm ? apm_battery_state : acpi_charge_state );
+}
+
 /*
  * All redraws come from this function (not children)
  */
 
-void BtryMeter::checkevent( void ){
-
-  getpwrinfo();
-
-  if ( old_apm_battery_state != apm_battery_state ) {
-    /* APM only changes if we have APM */
-    handle_apm_state();
-    drawlegend();
-    drawfields(1);
+void BtryMeter::render( void ){
+  if ( !latch() )
     return;
-  }
 
-  if ( old_acpi_charge_state != acpi_charge_state ) {
-    handle_acpi_state();
+  if ( shownstate_ != _drawnstate ) {
+    _drawnstate = shownstate_;
+    if ( use_apm )
+      handle_apm_state( shownstate_ );
+    else
+      handle_acpi_state( shownstate_ );
     drawlegend();
     drawfields(1);
     return;
@@ -282,7 +320,7 @@ void BtryMeter::getpwrinfo( void ){
 
 
 bool BtryMeter::getapminfo( void ){
-  std::ifstream loadinfo( APMFILENAME );
+  const char *loadinfo = _apmfile.read();
 
 /* just a tiny note here about APM states:
    See: arch/i386/kernel/apm.c apm_get_info()
@@ -326,23 +364,18 @@ bool BtryMeter::getapminfo( void ){
            8) min = minutes; sec = seconds
 */
 
-  if ( !loadinfo.good() ){
+  if ( !loadinfo ){
     XOSDEBUG("Can not open file : %s\n", APMFILENAME);
     return false;
   }
 
-  int battery_status=0xff; // assume unknown as default
-  char buff[256];
+  unsigned int battery_status=0xff; // assume unknown as default
 
-  loadinfo >> buff >> buff >> buff >> buff >> std::hex >> battery_status >> buff >> fields_[0];
+  sscanf(loadinfo, "%*s %*s %*s %*s %x %*s %lf", &battery_status, &fields_[0]);
 
 
   // XOSDEBUG("apm battery_status is: %d\n",battery_status);
 
-  // save previous state
-  // if there was no state-change - the gui won't do full redraw
-
-  old_apm_battery_state=apm_battery_state;
   apm_battery_state=battery_status;
 
   // If the battery status is reported as a negative number, it means we are
@@ -396,9 +429,6 @@ bool BtryMeter::getacpi_or_sys_info( void ){
   acpi_sum_rate=0;
   acpi_sum_alarm=0;
 
-  // save old state
-  old_acpi_charge_state=acpi_charge_state;
-
   acpi_charge_state=0; // assume charged
 
   for (struct dirent *dirent; (dirent = readdir(dir)) != NULL; ) {
@@ -471,21 +501,11 @@ bool BtryMeter::getacpi_or_sys_info( void ){
 // by adding/removing a battery
 bool BtryMeter::acpi_battery_present(const std::string& filename)
 {
-  std::ifstream loadinfo( filename.c_str() );
-
-  std::string argname;
-  std::string argval;
-
-  while ( !loadinfo.eof() ) {
+  const char *val = acpivalue(readfile(filename), "present");
 
-	argname.clear(); argval.clear();
-	loadinfo >> argname >> argval;
-
-	XOSDEBUG("batt ?: a=\"%s\" v=\"%s\"\n",argname.c_str(),argval.c_str() );
-	if ( argname == "present:" )
-           if ( argval == "yes" )
-		return true;
-  }
+  XOSDEBUG("batt ?: present v=\"%s\"\n", val ? val : "");
+  if ( isword(val, "yes") )
+    return true;
   XOSDEBUG("batt %s not present\n",filename.c_str() );
   return false;
 }
@@ -495,94 +515,34 @@ bool BtryMeter::acpi_parse_battery(const std::string& dirname)
   // actually there are THREE files to check:
   // 'alarm', 'info' and 'state'
 
-  std::string filename;
-  std::ifstream loadinfo;
-  std::istringstream inp_strm;
-  std::string inp_line;
-
-  std::string argname;
-  std::string argval;
-
-  filename = dirname + "/alarm";
-  loadinfo.open(filename.c_str() );
-  while ( loadinfo.good() ) {
-	std::getline(loadinfo,inp_line);
-	inp_strm.str(inp_line.c_str() );
-	argname.clear(); argval.clear();
-	inp_strm >> argname >> argval;
-	XOSDEBUG("alarm: a=\"%s\" v=\"%s\"\n",argname.c_str(),argval.c_str() );
-
-	if ( argname == "alarm:" ) {
-		battery.alarm = atoi(argval.c_str());
-		break;
-	}
-  }
-  loadinfo.close(); loadinfo.clear();
-
-  filename = dirname + "/info";
-  loadinfo.open(filename.c_str() );
-  while ( loadinfo.good() ) {
-
-	argname.clear();
-	std::getline(loadinfo,argname,':');
-
-	argval.clear();
-	std::getline(loadinfo,argval);
-
-	XOSDEBUG("info: a=\"%s\" v=\"%s\"\n",argname.c_str(),argval.c_str() );
-
-	if ( argname == "design capacity" ) {
-		battery.design_capacity=atoi(argval.c_str() );
-	}
-	if ( argname == "last full capacity" ) {
-		battery.last_full_capacity=atoi(argval.c_str() );
-	}
-	if ( argname == "last full capacity" ) {
-		battery.last_full_capacity=atoi(argval.c_str() );
-	}
+  const char *buf, *val;
 
+  buf = readfile(dirname + "/alarm");
+  if ( (val = acpivalue(buf, "alarm")) ) {
+	XOSDEBUG("alarm: v=\"%.*s\"\n", (int)strcspn(val, "\n"), val);
+	battery.alarm = atoi(val);
   }
-  loadinfo.close(); loadinfo.clear(); // clear eof-bit
-
-  filename = dirname + "/state";
-  loadinfo.open(filename.c_str() );
-  while ( loadinfo.good() ) {
-
-	// argname can contain spaces
-	argname.clear();
-	std::getline(loadinfo,argname,':');
-
-	// argval should NOT contain blanks
-	inp_line.clear();
-	std::getline(loadinfo,inp_line);
-	inp_strm.clear(); inp_strm.seekg(0);
-	inp_strm.str(inp_line.c_str() );
-
-	argval.clear();
-	inp_strm >> argval; // this ignores leading spaces
-
-	XOSDEBUG("state: a=\"%s\" v=\"%s\"\n",argname.c_str(),argval.c_str() );
-
-	if ( argname == "charging state" ) {
-		if ( argval == "charged" )
-			battery.charging_state=0;
-		if ( argval == "discharging" )
-			battery.charging_state=-1;
-		if ( argval == "charging" )
-			battery.charging_state=1;
-	}
-
-	if ( argname == "last full capacity" ) {
-		battery.last_full_capacity=atoi(argval.c_str() );
-	}
-	if ( argname == "last full capacity" ) {
-		battery.last_full_capacity=atoi(argval.c_str() );
-	}
-	if ( argname == "remaining capacity" ) {
-		battery.remaining_capacity=atoi(argval.c_str() );
-	}
 
+  buf = readfile(dirname + "/info");
+  if ( (val = acpivalue(buf, "design capacity")) )
+	battery.design_capacity = atoi(val);
+  if ( (val = acpivalue(buf, "last full capacity")) )
+	battery.last_full_capacity = atoi(val);
+
+  buf = readfile(dirname + "/state");
+  if ( (val = acpivalue(buf, "charging state")) ) {
+	XOSDEBUG("state: v=\"%.*s\"\n", (int)strcspn(val, "\n"), val);
+	if ( isword(val, "charged") )
+		battery.charging_state=0;
+	if ( isword(val, "discharging") )
+		battery.charging_state=-1;
+	if ( isword(val, "charging") )
+		battery.charging_state=1;
   }
+  if ( (val = acpivalue(buf, "last full capacity")) )
+	battery.last_full_capacity = atoi(val);
+  if ( (val = acpivalue(buf, "remaining capacity")) )
+	battery.remaining_capacity = atoi(val);
 
 return true;
 }
@@ -591,105 +551,50 @@ return true;
 // by adding/removing a battery
 bool BtryMeter::sys_battery_present(const std::string& filename)
 {
-  std::ifstream loadinfo( filename.c_str() );
-  std::string value;
-
-  while ( loadinfo.good() ) {
-
-	value.clear();
-	loadinfo >> value;
-
-    if (value == "1")
-	  return true;
-  }
+  if ( isword(readfile(filename), "1") )
+	return true;
   XOSDEBUG("batt %s not present\n",filename.c_str() );
   return false;
 }
 
 bool BtryMeter::sys_parse_battery(const std::string& dirname)
 {
-  std::string filename;
-  std::ifstream loadinfo;
-  std::string value;
-  struct stat stbuf;
+  const char *value;
 
-  filename = dirname + "/alarm";
-  loadinfo.open(filename.c_str() );
-  while ( loadinfo.good() ) {
-	value.clear();
-	loadinfo >> value;
-	XOSDEBUG("alarm (%s): v=\"%s\"\n", filename.c_str(), value.c_str() );
-    battery.alarm = atoi(value.c_str());
-    break;
-  }
-  loadinfo.close();
-  loadinfo.clear();
-
-  filename = dirname + "/energy_full_design";
-  if (stat(filename.c_str(),&stbuf)!=0)
-     filename=dirname+"/charge_full_design";
-  loadinfo.open(filename.c_str() );
-  while ( loadinfo.good() ) {
-	value.clear();
-	loadinfo >> value;
-	XOSDEBUG("design_capacity (%s): v=\"%s\"\n", filename.c_str(), value.c_str() );
-    battery.design_capacity = atoi(value.c_str());
-    break;
+  // Batteries report either energy_* (uWh) or charge_* (uAh).
+  if ( (value = readfile(dirname + "/alarm")) ) {
+	XOSDEBUG("alarm: v=\"%d\"\n", atoi(value));
+    battery.alarm = atoi(value);
   }
-  loadinfo.close();
-  loadinfo.clear();
-
-  filename = dirname + "/energy_full";
-  if (stat(filename.c_str(),&stbuf)!=0)
-     filename=dirname+"/charge_full";
-  loadinfo.open(filename.c_str() );
-  if (!loadinfo.good()) {
-	loadinfo.close();
-	loadinfo.clear();
-	filename=dirname+"/charge_full_design";
-	loadinfo.open(filename.c_str());
+
+  if ( (value = readfile(dirname + "/energy_full_design")) ||
+       (value = readfile(dirname + "/charge_full_design")) ) {
+	XOSDEBUG("design_capacity: v=\"%d\"\n", atoi(value));
+    battery.design_capacity = atoi(value);
   }
 
-  while ( loadinfo.good() ) {
-	value.clear();
-	loadinfo >> value;
-	XOSDEBUG("last_full_capacity (%s): v=\"%s\"\n", filename.c_str(), value.c_str() );
-    battery.last_full_capacity = atoi(value.c_str());
-    break;
+  if ( (value = readfile(dirname + "/energy_full")) ||
+       (value = readfile(dirname + "/charge_full")) ||
+       (value = readfile(dirname + "/charge_full_design")) ) {
+	XOSDEBUG("last_full_capacity: v=\"%d\"\n", atoi(value));
+    battery.last_full_capacity = atoi(value);
   }
-  loadinfo.close();
-  loadinfo.clear();
-
-  filename = dirname + "/energy_now";
-  if (stat(filename.c_str(),&stbuf)!=0)
-     filename=dirname+"/charge_now";
-  loadinfo.open(filename.c_str() );
-  while ( loadinfo.good() ) {
-	value.clear();
-	loadinfo >> value;
-	XOSDEBUG("remaining_capacity (%s): v=\"%s\"\n", filename.c_str(), value.c_str() );
-    battery.remaining_capacity = atoi(value.c_str());
-    break;
+
+  if ( (value = readfile(dirname + "/energy_now")) ||
+       (value = readfile(dirname + "/charge_now")) ) {
+	XOSDEBUG("remaining_capacity: v=\"%d\"\n", atoi(value));
+    battery.remaining_capacity = atoi(value);
   }
-  loadinfo.close();
-  loadinfo.clear();
 
-  filename = dirname + "/status";
-  loadinfo.open(filename.c_str() );
-  while ( loadinfo.good() ) {
-	value.clear();
-	loadinfo >> value;
-	XOSDEBUG("status (%s): v=\"%s\"\n", filename.c_str(), value.c_str() );
+  if ( (value = readfile(dirname + "/status")) ) {
+	XOSDEBUG("status: v=\"%.*s\"\n", (int)strcspn(value, "\n"), value);
 
     battery.charging_state=0;
-    if ( value == "Discharging" )
+    if ( isword(value, "Discharging") )
         battery.charging_state=-1;
-    if ( value == "Charging" )
+    if ( isword(value, "Charging") )
         battery.charging_state=1;
-    break;
   }
-  loadinfo.close();
-  loadinfo.clear();
 
   return true;
 }
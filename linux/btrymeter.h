@@ -9,7 +9,9 @@
 
 #include "fieldmeter.h"
 #include "xosview.h"
+#include "procfile.h"
 #include <string>
+#include <map>
 
 
 class BtryMeter : public FieldMeter {
@@ -18,7 +20,9 @@ public:
   ~BtryMeter( void );
 
   const char *name( void ) const { return "BtryMeter"; }
-  void checkevent( void );
+  bool splitSample( void ) const { return true; }
+  void sample( void );
+  void render( void );
 
   void checkResources( void );
 
@@ -51,25 +55,27 @@ private:
   bool acpi_parse_battery(const std::string& filename);
   bool sys_battery_present(const std::string& filename);
   bool sys_parse_battery(const std::string& filename);
+  const char *readfile(const std::string& filename);
 
   static bool has_acpi(void);
   static bool has_apm(void);
   static bool has_syspower(void);
 
-  void handle_apm_state(void);
-  void handle_acpi_state(void);
+  void handle_apm_state(int state);
+  void handle_acpi_state(int state);
+  int currentstate(void) const;
 
   int apm_battery_state;
-  int old_apm_battery_state;
-
   int acpi_charge_state;
-  int old_acpi_charge_state;
+  int _drawnstate;  // state_ the legend and colors were last set for
 
   int acpi_sum_cap;
   int acpi_sum_remain;
   int acpi_sum_rate;
   int acpi_sum_alarm;
 
+  ProcFile _apmfile;
+  std::map<std::string, ProcFile *> _files;
 };
 
 
@@ -37,7 +37,8 @@ CoreTemp::CoreTemp( XOSView *parent, const char *label, const char *caption, int
 }
 
 CoreTemp::~CoreTemp( void ) {
-
+  for (uint i = 0; i < _files.size(); i++)
+    delete _files[i];
 }
 
 void CoreTemp::checkResources( void ) {
@@ -56,6 +57,8 @@ void CoreTemp::checkResources( void ) {
     std::cerr << "BUG: Could not determine sysfs file(s) for coretemp." << std::endl;
     parent_->done(1);
   }
+  for (uint i = _files.size(); i < _cpus.size(); i++)
+    _files.push_back(new ProcFile(_cpus[i].c_str()));
 
   // Get TjMax and use it for total, if available.
   // Not found on k8temp and via-cputemp.
@@ -176,45 +179,37 @@ void CoreTemp::checkevent( void ) {
   drawfields();
 }
 
+bool CoreTemp::readtemp( unsigned int i, double *temp ) {
+  const char *buf = _files[i]->read();
+  if (!buf) {
+    std::cerr << "Can not open file : " << _files[i]->filename() << std::endl;
+    parent_->done(1);
+    return false;
+  }
+  *temp = strtod(buf, NULL);
+  return true;
+}
+
 void CoreTemp::getcoretemp( void ) {
-  std::ifstream file;
   double dummy;
   fields_[0] = 0.0;
 
   if (_cpu >= 0) {  // only one core
-    file.open(_cpus.back().c_str());
-    if (!file) {
-      std::cerr << "Can not open file : " << _cpus.back().c_str() << std::endl;
-      parent_->done(1);
+    if ( !readtemp(_files.size() - 1, &fields_[0]) )
       return;
-    }
-    file >> fields_[0];
-    file.close();
   }
   else if (_cpu == -1) {  // average
-    for (uint i = 0; i < _cpus.size(); i++) {
-      file.open(_cpus[i].c_str());
-      if (!file) {
-        std::cerr << "Can not open file : " << _cpus[i].c_str() << std::endl;
-        parent_->done(1);
+    for (uint i = 0; i < _files.size(); i++) {
+      if ( !readtemp(i, &dummy) )
         return;
-      }
-      file >> dummy;
-      file.close();
       fields_[0] += dummy;
     }
-    fields_[0] /= (double)_cpus.size();
+    fields_[0] /= (double)_files.size();
   }
   else if (_cpu == -2) {  // maximum
-    for (uint i = 0; i < _cpus.size(); i++) {
-      file.open(_cpus[i].c_str());
-      if (!file) {
-        std::cerr << "Can not open file : " << _cpus[i].c_str() << std::endl;
-        parent_->done(1);
+    for (uint i = 0; i < _files.size(); i++) {
+      if ( !readtemp(i, &dummy) )
         return;
-      }
-      file >> dummy;
-      file.close();
       if (dummy > fields_[0])
         fields_[0] = dummy;
     }
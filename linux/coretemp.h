@@ -13,6 +13,7 @@
 
 #include "fieldmeter.h"
 #include "xosview.h"
+#include "procfile.h"
 #include <string>
 #include <vector>
 
@@ -34,8 +35,10 @@ protected:
 
 private:
   void findSysFiles( void );
+  bool readtemp( unsigned int i, double *temp );
   int _pkg, _cpu, _high;
   std::vector<std::string> _cpus;
+  std::vector<ProcFile *> _files;
   unsigned long _actcolor, _highcolor;
 };
 
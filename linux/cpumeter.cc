@@ -5,6 +5,7 @@
 //
 
 #include "cpumeter.h"
+#include "procstat.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -12,16 +13,15 @@
 #include <sys/utsname.h>
 #include <string>
 #include <iostream>
-#include <fstream>
 
-static const char STATFILENAME[] = "/proc/stat";
 static int cputime_to_field[10] = { 0, 1, 2, 9, 5, 4, 3, 8, 6, 7 };
 
 #define MAX_PROCSTAT_LENGTH 4096
 
 CPUMeter::CPUMeter(XOSView *parent, const char *cpuID)
 : FieldMeterGraph( parent, 10, toUpper(cpuID), "USR/NIC/SYS/SI/HI/WIO/GST/NGS/STL/IDLE" ) {
-  _lineNum = findLine(cpuID);
+  _cpuNum = ( cpuID[3] ? atoi(cpuID + 3) : -1 );  // "cpu" is the aggregate
+  _row = ProcStat::instance().cpuRow(_cpuNum);
   for ( int i = 0 ; i < 2 ; i++ )
     for ( int j = 0 ; j < 10 ; j++ )
       cputime_[i][j] = 0;
@@ -57,7 +57,7 @@ void CPUMeter::checkResources( void ){
   unsigned long idlecolor = parent_->allocColor(parent_->getResource( "cpuFreeColor" ) );
 
   priority_ = atoi(parent_->getResource( "cpuPriority" ) );
-  dodecay_ = parent_->isResourceTrue( "cpuDecay" );
+  useDecay( "cpuDecay" );
   useGraph_ = parent_->isResourceTrue( "cpuGraph" );
   SetUsedFormat(parent_->getResource("cpuUsedFormat") );
 
@@ -219,37 +219,21 @@ void CPUMeter::checkResources( void ){
   numfields_ = field; // can't use setNumFields as it destroys the color mapping
 }
 
-void CPUMeter::checkevent( void ){
+void CPUMeter::sample( void ){
   getcputime();
-  drawfields();
 }
 
 void CPUMeter::getcputime( void ){
   total_ = 0;
-  std::string tmp;
-  std::ifstream stats( STATFILENAME );
-  char *end = NULL;
+  ProcStat &stat = ProcStat::instance();
+  stat.update(parent_->tick());
 
-  if ( !stats ){
-    std::cerr <<"Can not open file : " <<STATFILENAME << std::endl;
-    exit( 1 );
-  }
-
-  // read until we are at the right line.
-  for (int i = 0 ; i < _lineNum ; i++) {
-    if (stats.eof())
+  // CPUs going on- or offline move the lines around.
+  if (_row < 0 || _row >= stat.rows() || stat.cpuNum(_row) != _cpuNum)
+    if ( (_row = stat.cpuRow(_cpuNum)) < 0 )
       return;
-    stats.ignore(1024, '\n');
-  }
-  std::getline(stats, tmp);
 
-  int col = 0;
-  std::string l = tmp.substr(tmp.find_first_of(' ') + 1);
-  const char *line = l.c_str();
-  while (*line) {
-    cputime_[cpuindex_][col++] = strtoull(line, &end, 10);
-    line = end;
-  }
+  memcpy(cputime_[cpuindex_], stat.cputime(_row), sizeof(cputime_[0]));
 
   // Guest time already included in user time.
   cputime_[cpuindex_][0] -= cputime_[cpuindex_][8];
@@ -274,44 +258,9 @@ void CPUMeter::getcputime( void ){
   }
 }
 
-int CPUMeter::findLine(const char *cpuID){
-  std::ifstream stats( STATFILENAME );
-
-  if ( !stats ){
-    std::cerr <<"Can not open file : " <<STATFILENAME << std::endl;
-    exit( 1 );
-  }
-
-  int line = -1;
-  std::string buf;
-  while (!stats.eof()){
-    getline(stats, buf);
-    if (!stats.eof()){
-      line++;
-      if (!strncmp(cpuID, buf.data(), strlen(cpuID))
-        && buf[strlen(cpuID)] == ' ')
-        return line;
-    }
-  }
-  return -1;
-}
-
 // Returns the number of cpus that are on this machine.
 int CPUMeter::countCPUs(void){
-  std::ifstream stats( STATFILENAME );
-
-  if ( !stats ){
-    std::cerr <<"Can not open file : " <<STATFILENAME << std::endl;
-    exit( 1 );
-  }
-
-  int cpuCount = 0;
-  std::string buf;
-  while (getline(stats, buf))
-      if (!strncmp(buf.data(), "cpu", 3) && buf[3] != ' ')
-          cpuCount++;
-
-  return cpuCount;
+  return ProcStat::instance().cpuCount();
 }
 
 const char *CPUMeter::cpuStr(int num){
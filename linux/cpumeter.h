@@ -17,7 +17,8 @@ public:
   ~CPUMeter(void);
 
   const char *name(void) const { return "CPUMeter"; }
-  void checkevent(void);
+  bool splitSample(void) const { return true; }
+  void sample(void);
 
   void checkResources(void);
 
@@ -25,14 +26,13 @@ public:
   static const char *cpuStr(int num);
   static int getkernelversion(void);
 protected:
-  int _lineNum;
+  int _cpuNum, _row;
   unsigned long long cputime_[2][10];
   int cpuindex_;
   int kernel_;
   int statfields_;
 
   void getcputime(void);
-  int findLine(const char *cpuID);
   const char *toUpper(const char *str);
 private:
 };
@@ -0,0 +1,141 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _DECPARSE_H_
+#define _DECPARSE_H_
+
+//  Parsing of the blank separated unsigned decimal columns that make up
+//  most of /proc (/proc/stat, /proc/interrupts, /proc/net/dev, ...).
+//  Used in place of strtoull() on the per-tick paths.  Blanks are
+//  spaces and tabs, a newline ends a run of numbers.
+//
+//  On x86 with SSE4.2 (checked at run time) a number of up to 15 digits
+//  is converted with a handful of vector instructions instead of one
+//  multiply per digit.  Everything else goes through the plain loop,
+//  which stops at the largest value on overflow, as strtoull() does.
+
+#include <stdint.h>
+
+#if (defined(__i386__) || defined(__x86_64__)) && defined(__GNUC__)
+#define DECPARSE_SSE
+#include <immintrin.h>
+#endif
+
+
+inline const char *decparseBlanks( const char *cur ){
+  while (*cur == ' ' || *cur == '\t')
+    cur++;
+  return cur;
+}
+
+inline bool decparseIsDigit( char c ){
+  return (unsigned char)(c - '0') <= 9;
+}
+
+//  The digits at cur (there is at least one).  Like strtoull(), a
+//  number too large for 64 bits is taken whole and gives the largest
+//  value, rather than wrapping around.
+inline const char *decparseScalar( const char *cur, unsigned long long *val ){
+  const char *first = cur;
+  unsigned long long v = 0;
+
+  //  19 digits always fit, only the ones after need checking.
+  while (decparseIsDigit(*cur) && cur - first < 19)
+    v = v * 10 + (*cur++ - '0');
+  for ( ; decparseIsDigit(*cur) ; cur++) {
+    unsigned int digit = *cur - '0';
+    v = ( v > (~0ULL - digit) / 10 ? ~0ULL : v * 10 + digit );
+  }
+  *val = v;
+  return cur;
+}
+
+#ifdef DECPARSE_SSE
+//  Same as decparseScalar().  Loads 16 bytes at cur, which is only done
+//  if they do not cross into the next (maybe unmapped) page.
+__attribute__((target("sse4.2")))
+inline const char *decparseSSE( const char *cur, unsigned long long *val ){
+  if (((uintptr_t)cur & 4095) > 4096 - 16)
+    return decparseScalar(cur, val);
+
+  __m128i chunk = _mm_loadu_si128((const __m128i *)cur);
+  __m128i d = _mm_sub_epi8(chunk, _mm_set1_epi8('0'));
+  __m128i isdigit = _mm_and_si128(_mm_cmpgt_epi8(d, _mm_set1_epi8(-1)),
+                                  _mm_cmplt_epi8(d, _mm_set1_epi8(10)));
+  unsigned int len = __builtin_ctz(~_mm_movemask_epi8(isdigit) | 0x10000);
+  if (len == 16)
+    return decparseScalar(cur, val);  // 16 or more digits, rare
+
+  //  Right align the digits (negative shuffle indexes give zeros), then
+  //  fold pairs, quads and octets together.
+  d = _mm_shuffle_epi8(d, _mm_add_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7,
+                                                     8, 9, 10, 11, 12, 13,
+                                                     14, 15),
+                                       _mm_set1_epi8(len - 16)));
+  d = _mm_maddubs_epi16(d, _mm_set_epi8(1, 10, 1, 10, 1, 10, 1, 10,
+                                        1, 10, 1, 10, 1, 10, 1, 10));
+  d = _mm_madd_epi16(d, _mm_set_epi16(1, 100, 1, 100, 1, 100, 1, 100));
+  d = _mm_packus_epi32(d, d);
+  d = _mm_madd_epi16(d, _mm_set_epi16(1, 10000, 1, 10000,
+                                      1, 10000, 1, 10000));
+  *val = (unsigned long long)(uint32_t)_mm_cvtsi128_si32(d) * 100000000ULL
+    + (uint32_t)_mm_extract_epi32(d, 1);
+  return cur + len;
+}
+
+inline bool decparseHaveSSE( void ){
+  static const bool have = ( __builtin_cpu_init(),
+                             __builtin_cpu_supports("sse4.2") );
+  return have;
+}
+#endif
+
+//  Parse the number at cur, after any blanks.  Returns the first
+//  character after it, or NULL if there is no number.
+inline const char *decparse( const char *cur, unsigned long long *val ){
+  cur = decparseBlanks(cur);
+  if (!decparseIsDigit(*cur))
+    return 0;
+#ifdef DECPARSE_SSE
+  if (decparseHaveSSE())
+    return decparseSSE(cur, val);
+#endif
+  return decparseScalar(cur, val);
+}
+
+//  Parse up to n blank separated numbers into vals, stopping early at
+//  anything else (text, newline, end of string).  Returns how many were
+//  parsed, *end is left after the last one.
+template <class T>
+inline int decparse( const char *cur, T *vals, int n, const char **end ){
+  unsigned long long v;
+  int i = 0;
+
+#ifdef DECPARSE_SSE
+  if (decparseHaveSSE()) {
+    for ( ; i < n ; i++) {
+      cur = decparseBlanks(cur);
+      if (!decparseIsDigit(*cur))
+        break;
+      cur = decparseSSE(cur, &v);
+      vals[i] = v;
+    }
+    *end = cur;
+    return i;
+  }
+#endif
+  for ( ; i < n ; i++) {
+    cur = decparseBlanks(cur);
+    if (!decparseIsDigit(*cur))
+      break;
+    cur = decparseScalar(cur, &v);
+    vals[i] = v;
+  }
+  *end = cur;
+  return i;
+}
+
+#endif
@@ -5,28 +5,32 @@
 //
 
 #include "diskmeter.h"
+#include "procstat.h"
+#include "decparse.h"
 #include <stdlib.h>
 #include <stdio.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <unistd.h>
 #include <string.h>
 #include <dirent.h>
 #include <errno.h>
-#include <limits.h>
-#include <fstream>
 #include <iostream>
 #include <string>
 
-#define MAX_PROCSTAT_LENGTH 4096
+// The kernel's counters are unsigned longs.
+static const int DISKCOUNTERBITS = 8 * sizeof(unsigned long);
 
 
 DiskMeter::DiskMeter( XOSView *parent, float max ) : FieldMeterGraph(
   parent, 3, "DISK", "READ/WRITE/IDLE"), _vmstat(false),
   _statFileName("/proc/stat")
 {
-    read_prev_ = 0;
-    write_prev_ = 0;
     maxspeed_ = max;
+    _uevent = -1;
+    _rescan = true;
 
     _sysfs=_vmstat=false;
     struct stat buf;
@@ -38,6 +42,25 @@ DiskMeter::DiskMeter( XOSView *parent, float max ) : FieldMeterGraph(
         _sysfs = true;
         _statFileName = "/sys/block";
         XOSDEBUG("diskmeter: using sysfs /sys/block\n");
+
+        // Listen for disks coming and going, so /sys/block need only
+        // be walked again when that happens.
+        _uevent = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+          NETLINK_KOBJECT_UEVENT);
+        if (_uevent >= 0) {
+            struct sockaddr_nl addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.nl_family = AF_NETLINK;
+            addr.nl_groups = 1;  // kernel events
+            if (bind(_uevent, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+                close(_uevent);
+                _uevent = -1;
+            }
+        }
+        if (_uevent < 0)
+            XOSDEBUG("diskmeter: no uevents, rescanning %s every time\n",
+              _statFileName);
+
         getsysfsdiskinfo();
 
     } else  // try vmstat:
@@ -47,16 +70,24 @@ DiskMeter::DiskMeter( XOSView *parent, float max ) : FieldMeterGraph(
         _vmstat = true;
         _sysfs  = false;
         _statFileName = "/proc/vmstat";
+        _vmstatfile.filename(_statFileName);
+        _sectors.resize(2, DISKCOUNTERBITS);
         getvmdiskinfo();
 
-    } else // fall back to stat
+    } else { // fall back to stat
+        _sectors.resize(2, DISKCOUNTERBITS);
         getdiskinfo();
+    }
 
 
 }
 
 DiskMeter::~DiskMeter( void )
     {
+    for (unsigned int i = 0; i < _disks.size(); i++)
+        delete _disks[i].stat;
+    if (_uevent >= 0)
+        close(_uevent);
     }
 
 void DiskMeter::checkResources( void )
@@ -67,12 +98,13 @@ void DiskMeter::checkResources( void )
     setfieldcolor( 1, parent_->getResource("diskWriteColor") );
     setfieldcolor( 2, parent_->getResource("diskIdleColor") );
     priority_ = atoi (parent_->getResource( "diskPriority" ) );
-    dodecay_ = parent_->isResourceTrue("diskDecay" );
+    useDecay( "diskDecay" );
     useGraph_ = parent_->isResourceTrue( "diskGraph" );
     SetUsedFormat(parent_->getResource("diskUsedFormat"));
+    _autoscale.configure(parent_, "disk");
     }
 
-void DiskMeter::checkevent( void )
+void DiskMeter::sample( void )
     {
     if (_vmstat)
         getvmdiskinfo();
@@ -80,13 +112,10 @@ void DiskMeter::checkevent( void )
         getsysfsdiskinfo();
     else
         getdiskinfo();
-
-    drawfields();
-
     }
 
 // IMHO the logic here is quite broken - but for backward compat UNCHANGED:
-void DiskMeter::updateinfo(unsigned long one, unsigned long two,
+void DiskMeter::updatecounts(unsigned long one, unsigned long two,
   int fudgeFactor)
     {
     // assume each "unit" is 1k.
@@ -100,169 +129,164 @@ void DiskMeter::updateinfo(unsigned long one, unsigned long two,
 
     // So this is a FIXME - but how ???
 
-    float itim = IntervalTimeInMicrosecs();
-    unsigned long read_curr = one * fudgeFactor;  // FIXME!
-    unsigned long write_curr = two * fudgeFactor; // FIXME!
-
-    // avoid strange values at first call
-    if(read_prev_ == 0) read_prev_ = read_curr;
-    if(write_prev_ == 0) write_prev_ = write_curr;
+    unsigned long long counts[2] = { one, two };
+    _sectors.update(counts);
 
     // calculate rate in bytes per second
-    fields_[0] = ((read_curr - read_prev_) * 1e6 * 512) / itim;
-    fields_[1] = ((write_curr - write_prev_) * 1e6 * 512) / itim;
+    updateinfo(_sectors.rate(0) * fudgeFactor * 512,  // FIXME!
+      _sectors.rate(1) * fudgeFactor * 512);
+    }
 
-    // fix overflow (conversion bug?)
-    if (fields_[0] < 0.0)
-        fields_[0] = 0.0;
-    if (fields_[1] < 0.0)
-        fields_[1] = 0.0;
+void DiskMeter::updateinfo(double readrate, double writerate)
+    {
+    fields_[0] = readrate;
+    fields_[1] = writerate;
 
-    if (fields_[0] + fields_[1] > total_)
-       	total_ = fields_[0] + fields_[1];
+    // at least diskBandwidth, more after a burst
+    total_ = _autoscale.update(fields_[0] + fields_[1], maxspeed_);
 
     fields_[2] = total_ - (fields_[0] + fields_[1]);
 
-    read_prev_ = read_curr;
-    write_prev_ = write_curr;
-
-    setUsed((fields_[0]+fields_[1]), total_);
-    IntervalTimerStart();
+    setUsed(fields_[0] + fields_[1], total_);
     }
 
 void DiskMeter::getvmdiskinfo(void)
 {
-    IntervalTimerStop();
     total_ = maxspeed_;
-    char buf[MAX_PROCSTAT_LENGTH];
-    std::ifstream stats(_statFileName);
-    unsigned long one, two;
+    unsigned long one = 0, two = 0;
+    const char *val;
 
-    if ( !stats )
+    if ( !_vmstatfile.read() )
         {
         std::cerr <<"Can not open file : " << _statFileName << std::endl;
         exit( 1 );
         }
 
-
-    stats >> buf;
     // kernel >= 2.5
-    while (!stats.eof() && strncmp(buf, "pgpgin", 7))
-        {
-        stats.ignore(1024, '\n');
-        stats >> buf;
-        }
+    if ( (val = _vmstatfile.find("pgpgin")) )
+        one = strtoul(val, NULL, 10);
+    if ( (val = _vmstatfile.find("pgpgout")) )
+        two = strtoul(val, NULL, 10);
 
-    // read first value
-    stats >> one;
-
-    while (!stats.eof() && strncmp(buf, "pgpgout", 7))
-        {
-        stats.ignore(1024, '\n');
-        stats >> buf;
-        }
-
-    // read second value
-    stats >> two;
-
-    updateinfo(one, two, 4);
+    updatecounts(one, two, 4);
 }
 
 void DiskMeter::getdiskinfo( void )
 {
-    IntervalTimerStop();
     total_ = maxspeed_;
-    char buf[MAX_PROCSTAT_LENGTH];
-    std::ifstream stats(_statFileName);
-
-    if ( !stats )
-    {
-        std::cerr <<"Can not open file : " << _statFileName << std::endl;
-        exit( 1 );
-    }
-
-    // Find the line with 'page'
-    stats >> buf;
-    while (strncmp(buf, "disk_io:", 8))
-    {
-        stats.ignore(MAX_PROCSTAT_LENGTH, '\n');
-        stats >> buf;
-        if (stats.eof())
-            break;
-    }
+    ProcStat &stat = ProcStat::instance();
+    stat.update(parent_->tick());
 
-    // read values
+    // read values from the line with 'disk_io:'
     unsigned long one=0, two=0;
     unsigned long junk,read1,write1;
-    stats >> buf;
-    while (7 == sscanf(buf,"(%lu,%lu):(%lu,%lu,%lu,%lu,%lu)",&junk,&junk,&junk,&junk,&read1,&junk,&write1))
+    int n = 0;
+    const char *cur = stat.find("disk_io:");
+    while (cur && 7 == sscanf(cur," (%lu,%lu):(%lu,%lu,%lu,%lu,%lu)%n",&junk,&junk,&junk,&junk,&read1,&junk,&write1,&n))
     {
         one += read1;
         two += write1;
-        stats >> buf;
+        cur += n;
     }
 
-    updateinfo(one, two, 1);
+    updatecounts(one, two, 1);
 }
 
-// sysfs version - works with long-long !!
-void DiskMeter::update_info(const diskmap &reads, const diskmap &writes)
+// Drain the uevent socket.  True if a block device was added or removed.
+bool DiskMeter::checkuevents( void )
 {
-    float itim = IntervalTimeInMicrosecs();
-    // the sum of all disks
-    unsigned long long all_bytes_read = 0, all_bytes_written = 0;
-    unsigned int sect_size = 512; // from linux-3.10/Documentation/block/stat.txt
-
-    // avoid strange values at first call
-    // (by this - the first value displayed becomes zero)
-    if (sysfs_read_prev_.empty())
-    {
-        sysfs_read_prev_  = reads;
-        sysfs_write_prev_ = writes;
-        itim = 1;	// itim is garbage here too. Valgrind complains.
+    char buf[4096];
+    bool changed = false;
+    ssize_t len;
+
+    while ((len = recv(_uevent, buf, sizeof(buf) - 1, MSG_DONTWAIT)) > 0) {
+        // "action@devpath\0KEY=value\0KEY=value\0..."
+        bool block = false, addremove = false;
+        buf[len] = '\0';
+        for (const char *cur = buf; cur < buf + len; cur += strlen(cur) + 1) {
+            if (strcmp(cur, "SUBSYSTEM=block") == 0)
+                block = true;
+            else if (strcmp(cur, "ACTION=add") == 0 ||
+                     strcmp(cur, "ACTION=remove") == 0)
+                addremove = true;
+        }
+        if (block && addremove)
+            changed = true;
     }
+    if (len < 0 && errno == ENOBUFS)
+        changed = true;  // lost some, look for ourselves
 
-    for (diskmap::const_iterator it = reads.begin(); it != reads.end(); it++)
-    {
-        if (it->second < sysfs_read_prev_[it->first]) // counter wrapped
-            all_bytes_read += ULONG_MAX - sysfs_read_prev_[it->first] + it->second;
-        else
-            all_bytes_read += it->second - sysfs_read_prev_[it->first];
-    }
-    for (diskmap::const_iterator it = writes.begin(); it != writes.end(); it++)
-    {
-        if (it->second < sysfs_write_prev_[it->first]) // counter wrapped
-            all_bytes_written += ULONG_MAX - sysfs_write_prev_[it->first] + it->second;
-        else
-            all_bytes_written += it->second - sysfs_write_prev_[it->first];
-    }
+    return changed;
+}
 
-    all_bytes_read *= sect_size;
-    all_bytes_written *= sect_size;
-    XOSDEBUG("disk: read: %llu, written: %llu\n", all_bytes_read, all_bytes_written);
+// (Re)build the disk slots from /sys/block.  Disks that are still
+// there keep their slot and counters.
+void DiskMeter::scansysfsdisks( void )
+{
+  std::string sysfs_dir = _statFileName;
+  std::string disk, tmp;
+  struct stat buf;
+  std::vector<bool> seen(_disks.size(), false);
 
-    // convert rate from bytes/microsec into bytes/second
-    fields_[0] = all_bytes_read * ( 1e6 / itim );
-    fields_[1] = all_bytes_written * ( 1e6 / itim );
+  sysfs_dir += '/';
+  XOSDEBUG("sysfs: scanning %s\n", _statFileName);
 
-    // fix overflow (conversion bug?)
-    if (fields_[0] < 0.0)
-        fields_[0] = 0.0;
-    if (fields_[1] < 0.0)
-        fields_[1] = 0.0;
+  DIR *dir = opendir(_statFileName);
+  if (dir == NULL) {
+    XOSDEBUG("sysfs: Cannot open directory : %s\n", _statFileName);
+    return;
+  }
 
-    // bump up max total:
-    if (fields_[0] + fields_[1] > total_)
-        total_ = fields_[0] + fields_[1];
+  for (struct dirent *dirent; (dirent = readdir(dir)) != NULL; ) {
+    if (strncmp(dirent->d_name, ".", 1) == 0 ||
+        strncmp(dirent->d_name, "..", 2) == 0 ||
+        strncmp(dirent->d_name, "loop", 4) == 0 ||
+        strncmp(dirent->d_name, "ram", 3) == 0)
+      continue;
 
-    fields_[2] = total_ - (fields_[0] + fields_[1]);
+    disk = sysfs_dir + dirent->d_name;
+    if (stat(disk.c_str(), &buf) != 0 || !(buf.st_mode & S_IFDIR)) {
+      XOSDEBUG("disk is not dir: %s - errno=%d\n", disk.c_str(), errno);
+      continue;
+    }
+    // only scan for real HW (raid, md, and lvm all mapped on them)
+    tmp = disk + "/device";
+    if (lstat(tmp.c_str(), &buf) != 0 || (buf.st_mode & S_IFLNK) == 0)
+      continue;
 
-    // save old vals for next round
-    sysfs_read_prev_  = reads;
-    sysfs_write_prev_ = writes;
+    unsigned int slot, free = _disks.size();
+    for (slot = 0; slot < _disks.size(); slot++) {
+      if (_disks[slot].stat && _disks[slot].name == dirent->d_name)
+        break;
+      if (!_disks[slot].stat && free == _disks.size())
+        free = slot;
+    }
+    if (slot < _disks.size()) {  // still there
+      seen[slot] = true;
+      continue;
+    }
 
-    setUsed(fields_[0] + fields_[1], total_);
-    IntervalTimerStart();
+    if (free == _disks.size())
+      _disks.push_back(DiskSlot());
+    DiskSlot &d = _disks[free];
+    d.name = dirent->d_name;
+    d.stat = new ProcFile((disk + "/stat").c_str());
+    _sectors.resize(2 * _disks.size(), DISKCOUNTERBITS);
+    _sectors.restart(2 * free);
+    _sectors.restart(2 * free + 1);
+    if (free < seen.size())
+      seen[free] = true;
+    XOSDEBUG("sysfs: disk %s in slot %u\n", d.name.c_str(), free);
+  }
+  closedir(dir);
+
+  // free the slots of disks that went away
+  for (unsigned int i = 0; i < seen.size(); i++)
+    if (!seen[i] && _disks[i].stat) {
+      XOSDEBUG("sysfs: disk %s gone from slot %u\n", _disks[i].name.c_str(), i);
+      delete _disks[i].stat;
+      _disks[i].stat = NULL;
+    }
 }
 
 // XXX: sysfs - read Documentation/iostats.txt !!!
@@ -272,64 +296,49 @@ void DiskMeter::getsysfsdiskinfo( void )
 {
         // field-3: sects read since boot (but can wrap!)
         // field-7: sects written since boot (but can wrap!)
-        // just sum up everything in /sys/block/*/stat
+        // just sum up the rates of all disks
 
-  std::string sysfs_dir = _statFileName;
-  std::string disk, tmp;
-  std::ifstream diskstat;
-  struct stat buf;
-  char line[128];
+  unsigned int sect_size = 512; // from linux-3.10/Documentation/block/stat.txt
+  double reads = 0, writes = 0;
   unsigned long vals[7];
-  diskmap reads, writes;
+  const char *end;
 
-  IntervalTimerStop();
   total_ = maxspeed_;
-  sysfs_dir += '/';
 
-  DIR *dir = opendir(_statFileName);
-  if (dir == NULL) {
-    XOSDEBUG("sysfs: Cannot open directory : %s\n", _statFileName);
-    return;
+  if (_uevent < 0 || checkuevents())
+    _rescan = true;
+  if (_rescan) {
+    scansysfsdisks();
+    _rescan = false;
   }
 
-  // visit every /sys/block/*/stat and sum up the values:
-  for (struct dirent *dirent; (dirent = readdir(dir)) != NULL; ) {
-    if (strncmp(dirent->d_name, ".", 1) == 0 ||
-        strncmp(dirent->d_name, "..", 2) == 0 ||
-        strncmp(dirent->d_name, "loop", 4) == 0 ||
-        strncmp(dirent->d_name, "ram", 3) == 0)
+  // a free slot, or a disk that could not be read, stays where it was
+  _counts.resize(2 * _disks.size());
+  for (unsigned int i = 0; i < _disks.size(); i++) {
+    DiskSlot &d = _disks[i];
+    _counts[2 * i] = _sectors.last(2 * i);
+    _counts[2 * i + 1] = _sectors.last(2 * i + 1);
+    if (!d.stat)
       continue;
 
-    disk = sysfs_dir + dirent->d_name;
-    if (stat(disk.c_str(), &buf) == 0 && buf.st_mode & S_IFDIR) {
-      // only scan for real HW (raid, md, and lvm all mapped on them)
-      tmp = disk + "/device";
-      if (lstat(tmp.c_str(), &buf) != 0 || (buf.st_mode & S_IFLNK) == 0)
-        continue;
-
-      // is a dir, locate 'stat' file in it
-      disk += "/stat";
-      diskstat.open(disk.c_str());
-      if (diskstat.good()) {
-        diskstat.getline(line, 128);
-        char *cur = line, *end = NULL;
-        for (int i = 0; i < 7; i++) {
-          vals[i] = strtoul(cur, &end, 10);
-          cur = end;
-        }
-        reads[dirent->d_name]  = vals[2];
-        writes[dirent->d_name] = vals[6];
-
-        XOSDEBUG("disk stat: %s | read: %lu, written: %lu\n", disk.c_str(), vals[2], vals[6]);
-        diskstat.close();
-        diskstat.clear();
-      }
-      else
-        XOSDEBUG("disk stat open: %s - errno=%d\n", disk.c_str(), errno);
+    const char *line = d.stat->read();
+    if (!line || decparse(line, vals, 7, &end) < 7) {
+      XOSDEBUG("disk stat read: %s - errno=%d\n", d.stat->filename(), errno);
+      _rescan = true;
+      continue;
     }
-    else
-      XOSDEBUG("disk is not dir: %s - errno=%d\n", disk.c_str(), errno);
-  } // for
-  closedir(dir);
-  update_info(reads, writes);
+    XOSDEBUG("disk stat: %s | read: %lu, written: %lu\n", d.name.c_str(), vals[2], vals[6]);
+    _counts[2 * i] = vals[2];
+    _counts[2 * i + 1] = vals[6];
+  }
+
+  if (!_counts.empty())
+    _sectors.update(&_counts[0]);
+  for (unsigned int i = 0; i < _disks.size(); i++) {
+    reads += _sectors.rate(2 * i);
+    writes += _sectors.rate(2 * i + 1);
+  }
+
+  // convert rate from sectors/second into bytes/second
+  updateinfo(reads * sect_size, writes * sect_size);
 }
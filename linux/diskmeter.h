@@ -9,10 +9,11 @@
 
 #include "fieldmetergraph.h"
 #include "xosview.h"
-#include <map>
+#include "procfile.h"
+#include "counterrates.h"
+#include "autoscale.h"
 #include <string>
-
-typedef std::map<std::string, unsigned long> diskmap;
+#include <vector>
 
 
 class DiskMeter : public FieldMeterGraph
@@ -22,30 +23,43 @@ class DiskMeter : public FieldMeterGraph
         ~DiskMeter( void );
 
         const char *name( void ) const { return "DiskMeter"; }
-        void checkevent( void );
+        bool splitSample( void ) const { return true; }
+        void sample( void );
 
         void checkResources( void );
     protected:
 
         // sysfs:
-        void update_info(const diskmap &reads, const diskmap &writes);
         void getsysfsdiskinfo( void );
+        void scansysfsdisks( void );
+        bool checkuevents( void );
 
         void getdiskinfo( void );
         void getvmdiskinfo( void );
-        void updateinfo(unsigned long one, unsigned long two,
+        void updatecounts(unsigned long one, unsigned long two,
           int fudgeFactor);
+        void updateinfo(double readrate, double writerate);
     private:
 
-        // sysfs:
-        diskmap sysfs_read_prev_, sysfs_write_prev_;
+        // sysfs: one slot per disk in /sys/block.  A slot keeps its
+        // index while the disk is there, and is reused once it is gone.
+        struct DiskSlot {
+            std::string name;
+            ProcFile *stat;  // NULL for a free slot
+        };
+        std::vector<DiskSlot> _disks;
+        int _uevent;       // NETLINK_KOBJECT_UEVENT socket, or -1
+        bool _rescan;
         bool _sysfs;
 
-        unsigned long int read_prev_;
-        unsigned long int write_prev_;
+        // Sectors read and written, per disk slot with sysfs.
+        CounterRates _sectors;
+        std::vector<unsigned long long> _counts;
+        AutoScale _autoscale;
         float maxspeed_;
         bool _vmstat;
         const char *_statFileName;
+        ProcFile _vmstatfile;
     };
 
 #endif
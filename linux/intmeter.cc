@@ -5,16 +5,23 @@
 //
 
 #include "intmeter.h"
+#include "procinterrupts.h"
 #include <stdlib.h>
-#include <fstream>
-#include <string>
-#include <iostream>
 #include <sstream>
 #include <map>
 
-static const char *INTFILE     = "/proc/interrupts";
 static std::map<const int,int> realintnum;
-static const int max = 1024;
+
+//  The bit used for an irq.  Irqs 0-15 always have their own bits,
+//  others get the next free one the first time they are seen.
+static int irqindex( int irq ){
+  std::map<const int,int>::const_iterator it = realintnum.find(irq);
+  if (it != realintnum.end())
+    return it->second;
+  int idx = realintnum.size();
+  realintnum[irq] = idx;
+  return idx;
+}
 
 
 IntMeter::IntMeter( XOSView *parent, int cpu )
@@ -50,37 +57,17 @@ void IntMeter::checkResources( void ){
 }
 
 void IntMeter::getirqs( void ){
-  std::ifstream intfile( INTFILE );
-  std::string line;
-  int intno, idx, i;
-  unsigned long count, tmp;
-  char *end = NULL;
-
-  if ( !intfile ){
-    std::cerr <<"Can not open file : " <<INTFILE << std::endl;
-    exit( 1 );
-  }
-
-  intfile.ignore(max, '\n');
+  ProcInterrupts &ints = ProcInterrupts::instance();
+  ints.update(parent_->tick());
 
-  while ( !intfile.eof() ){
-    std::getline(intfile, line);
-    if ( line.find_first_of("0123456789") > line.find_first_of(':') )
-      break;  // reached non-numeric interrupts
-    idx = strtoul(line.c_str(), &end, 10);
-    if (idx >= max)
-      break;
-    intno = realintnum[idx];
+  for ( int row = 0 ; row < ints.rows() ; row++ ){
+    int intno = irqindex(ints.irq(row));
     if ( intno >= numBits() )
       updateirqcount(intno, false);
-    const char *cur = end + 1;
-    count = tmp = i = 0;
-    while (*cur && i++ <= _cpu) {
-      tmp = strtoul(cur, &end, 10);
-      count += tmp;
-      cur = end;
-    }
-    _irqs[intno] = ( _separate ? tmp : count );
+    if ( _separate )
+      _irqs[intno] = ( _cpu < ints.cpus() ? ints.counts(row)[_cpu] : 0 );
+    else
+      _irqs[intno] = ints.sum(row, _cpu + 1);
   }
 }
 
@@ -151,39 +138,22 @@ void IntMeter::updateirqcount( int n, bool init ){
 }
 
 /* Find the highest number of interrupts and call updateirqcount to
- * update the number of interrupts listed
+ * update the number of interrupts listed.  Irqs showing up later are
+ * added by getirqs().
  */
 void IntMeter::initirqcount( void ){
-  std::ifstream intfile( INTFILE );
+  ProcInterrupts &ints = ProcInterrupts::instance();
   int intno = 0;
-  int i, idx;
 
-  if ( !intfile ){
-    std::cerr <<"Can not open file : " <<INTFILE << std::endl;
-    exit( 1 );
-  }
+  ints.update(parent_->tick());
 
-  for (i = 0; i < 16; i++)
+  for (int i = 0; i < 16; i++)
     realintnum[i] = i;
 
-  intfile.ignore(max, '\n');
-
-  /* just looking for the highest number interrupt that
-   * is in use, ignore the rest of the data
-   */
-  idx = 16;
-  while ( !intfile.eof() ){
-    intfile >> i;
-    /* break when reaching non-numeric special interrupts */
-    if (!intfile)
-      break;
-    if (i < 16)
-      intno = i;
-    else {
+  for (int row = 0; row < ints.rows(); row++) {
+    int idx = irqindex(ints.irq(row));
+    if (idx > intno)
       intno = idx;
-      realintnum[i] = idx++;
-    }
-    intfile.ignore(max, '\n');
   }
   updateirqcount(intno, true);
 }
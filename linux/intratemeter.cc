@@ -10,19 +10,16 @@
 //
 
 #include "intratemeter.h"
-#include "cpumeter.h"
+#include "procinterrupts.h"
 #include <stdlib.h>
-#include <fstream>
-#include <string>
-#include <iostream>
 
-static const char *INTFILE = "/proc/interrupts";
+// The least the meter goes up to, in irqs per second.
+static const double IRQRATEFLOOR = 2000;
 
 
 IrqRateMeter::IrqRateMeter( XOSView *parent )
-  : FieldMeterGraph( parent, 2, "IRQs", "IRQs per sec/IDLE", 1, 1, 0 ) {
-  _lastirqs = 0;
-  _cpucount = CPUMeter::countCPUs();
+  : FieldMeterGraph( parent, 2, "IRQs", "IRQs per sec/IDLE", 1, 1, 0 ),
+    _irqs(1) {
 }
 
 IrqRateMeter::~IrqRateMeter( void ) {
@@ -33,10 +30,11 @@ void IrqRateMeter::checkResources( void ) {
   setfieldcolor( 0, parent_->getResource("irqrateUsedColor") );
   setfieldcolor( 1, parent_->getResource("irqrateIdleColor") );
   priority_ = atoi( parent_->getResource("irqratePriority") );
-  dodecay_ = parent_->isResourceTrue("irqrateDecay");
+  useDecay( "irqrateDecay" );
   useGraph_ = parent_->isResourceTrue("irqrateGraph");
   SetUsedFormat( parent_->getResource("irqrateUsedFormat") );
-  total_ = 2000;
+  _autoscale.configure( parent_, "irqrate" );
+  total_ = IRQRATEFLOOR;
 }
 
 void IrqRateMeter::checkevent( void ) {
@@ -45,45 +43,15 @@ void IrqRateMeter::checkevent( void ) {
 }
 
 void IrqRateMeter::getinfo( void ) {
-  std::ifstream intfile(INTFILE);
-  std::string line;
-  unsigned long long count = 0;
-  unsigned long tmp;
-  const char *cur = NULL;
-  char *end = NULL;
+  ProcInterrupts &ints = ProcInterrupts::instance();
+  ints.update(parent_->tick());
 
-  if (!intfile) {
-    std::cerr << "Can not open file : " << INTFILE << std::endl;
-    parent_->done(1);
-    return;
-  }
+  // sum all interrupts on all cpus; irqs going away count as a reset
+  unsigned long long count = ints.total();
+  _irqs.update(&count);
+  fields_[0] = _irqs.rate(0);
 
-  IntervalTimerStop();
-  intfile.ignore(1024, '\n');
-
-  // sum all interrupts on all cpus
-  while ( !intfile.eof() ) {
-    unsigned int i = 0;
-    std::getline(intfile, line);
-    if ( line.find_first_of("0123456789") > line.find_first_of(':') )
-      break;  // reached non-numeric interrupts
-    tmp = strtoul(line.c_str(), &end, 10);
-    cur = end + 1;
-    while (*cur && i++ < _cpucount) {
-      tmp = strtoul(cur, &end, 10);
-      count += tmp;
-      cur = end;
-    }
-  }
-  if (_lastirqs == 0)  // first run
-    _lastirqs = count;
-  fields_[0] = (count - _lastirqs) / IntervalTimeInSecs();
-  IntervalTimerStart();
-  _lastirqs = count;
-
-  // Bump total, if needed.
-  if (fields_[0] > total_)
-    total_ = fields_[0];
+  total_ = _autoscale.update(fields_[0], IRQRATEFLOOR);
 
   setUsed(fields_[0], total_);
 }
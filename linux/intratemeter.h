@@ -14,6 +14,8 @@
 
 #include "fieldmetergraph.h"
 #include "xosview.h"
+#include "counterrates.h"
+#include "autoscale.h"
 
 
 class IrqRateMeter : public FieldMeterGraph {
@@ -29,8 +31,8 @@ protected:
   void getinfo( void );
 
 private:
-  unsigned long long _lastirqs;
-  unsigned int _cpucount;
+  CounterRates _irqs;
+  AutoScale _autoscale;
 };
 
 
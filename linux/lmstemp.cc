@@ -318,10 +318,15 @@ void LmsTemp::checkResources( void ){
   snprintf(s, 32, "lmstempUsedFormat%d", _nbr);
   SetUsedFormat( parent_->getResourceOrUseDefault(s, tmp) );
 
-  if ( !_highfile.empty() )
+  _tempin.filename( _tempfile.c_str() );
+  if ( !_highfile.empty() ) {
     has_high_ = true;
-  if ( !_lowfile.empty() )
+    _highin.filename( _highfile.c_str() );
+  }
+  if ( !_lowfile.empty() ) {
     has_low_ = true;
+    _lowin.filename( _lowfile.c_str() );
+  }
 
   if (!has_high_)
     high_ = total_;
@@ -342,37 +347,32 @@ void LmsTemp::checkevent( void ){
 void LmsTemp::getlmstemp( void ){
   double high = high_, low = low_;
 
-  std::ifstream tempfile( _tempfile.c_str() );
-  if (!tempfile) {
+  const char *buf = _tempin.read();
+  if (!buf) {
     std::cerr << "Can not open file : " << _tempfile << std::endl;
     parent_->done(1);
     return;
   }
 
   if (_isproc)
-    tempfile >> high >> low >> fields_[0];
+    sscanf(buf, "%lf %lf %lf", &high, &low, &fields_[0]);
   else {
-    tempfile >> fields_[0];
-    fields_[0] /= _scale;
+    fields_[0] = strtod(buf, NULL) / _scale;
     if ( !_highfile.empty() ) {
-      std::ifstream highfile( _highfile.c_str() );
-      if (!highfile) {
+      if ( !(buf = _highin.read()) ) {
         std::cerr << "Can not open file : " << _highfile << std::endl;
         parent_->done(1);
         return;
       }
-      highfile >> high;
-      high /= _scale;
+      high = strtod(buf, NULL) / _scale;
     }
     if ( !_lowfile.empty() ) {
-      std::ifstream lowfile( _lowfile.c_str() );
-      if (!lowfile) {
+      if ( !(buf = _lowin.read()) ) {
         std::cerr << "Can not open file : " << _lowfile << std::endl;
         parent_->done(1);
         return;
       }
-      lowfile >> low;
-      low /= _scale;
+      low = strtod(buf, NULL) / _scale;
     }
   }
 
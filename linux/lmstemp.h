@@ -13,6 +13,7 @@
 
 #include "sensorfieldmeter.h"
 #include "xosview.h"
+#include "procfile.h"
 #include <string>
 
 
@@ -35,6 +36,7 @@ private:
   void determineScale( void );
   void determineUnit( void );
   std::string _tempfile, _highfile, _lowfile;
+  ProcFile _tempin, _highin, _lowin;
   unsigned int _nbr;
   double _scale;
   bool _isproc, _name_found, _temp_found, _high_found, _low_found;
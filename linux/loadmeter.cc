@@ -12,19 +12,19 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
-#include <fstream>
 #include <iostream>
-#include <string>
 
 static const char LOADFILENAME[] = "/proc/loadavg";
 static const char SPEEDFILENAME[] = "/proc/cpuinfo";
 
 
 LoadMeter::LoadMeter( XOSView *parent )
-  : FieldMeterGraph( parent, 2, "LOAD", "PROCS/MIN", 1, 1, 0 ){
-  lastalarmstate = -1;
+  : FieldMeterGraph( parent, 2, "LOAD", "PROCS/MIN", 1, 1, 0 ),
+  _loadfile(LOADFILENAME), _speedfile(SPEEDFILENAME) {
+  alarmstate = 0;
+  _drawnstate = -1;
   total_ = 2.0;
-  old_cpu_speed_= cur_cpu_speed_=0;
+  cur_cpu_speed_=0;
   do_cpu_speed = 0;
 
 }
@@ -43,7 +43,7 @@ void LoadMeter::checkResources( void ){
   setfieldcolor( 1, parent_->getResource( "loadIdleColor" ) );
   priority_ = atoi (parent_->getResource( "loadPriority" ) );
   useGraph_ = parent_->isResourceTrue( "loadGraph" );
-  dodecay_ = parent_->isResourceTrue( "loadDecay" );
+  useDecay( "loadDecay" );
   SetUsedFormat (parent_->getResource("loadUsedFormat"));
 
   const char *warn = parent_->getResource("loadWarnThreshold");
@@ -61,6 +61,7 @@ void LoadMeter::checkResources( void ){
   }
 
   do_cpu_speed  = parent_->isResourceTrue( "loadCpuSpeed" );
+  _autoscale.configure( parent_, "load" );
 
   if (dodecay_){
     //  Warning:  Since the loadmeter changes scale occasionally, old
@@ -76,17 +77,36 @@ void LoadMeter::checkResources( void ){
   }
 }
 
-void LoadMeter::checkevent( void ){
+void LoadMeter::sample( void ){
   getloadinfo();
-  if ( do_cpu_speed ) {
+  if ( do_cpu_speed )
     getspeedinfo();
-    if ( old_cpu_speed_ != cur_cpu_speed_ ) {
+  //  The color of the load and the speed in the legend go along with
+  //  the values, for render().
+  state_ = cur_cpu_speed_ * 4 + alarmstate;
+}
+
+void LoadMeter::render( void ){
+  if ( !latch() )
+    return;
+
+  if ( shownstate_ != _drawnstate ) {
+    int alarm = shownstate_ % 4, speed = shownstate_ / 4;
+    if ( alarm != _drawnstate % 4 ) {
+      if ( alarm == 0 ) setfieldcolor( 0, procloadcol_ );
+      else
+      if ( alarm == 1 ) setfieldcolor( 0, warnloadcol_ );
+      else
+      /* if alarm == 2 */ setfieldcolor( 0, critloadcol_ );
+    }
+    if ( speed != _drawnstate / 4 ) {
       // update the legend:
       char l[32];
-      snprintf(l, 32, "PROCS/MIN %d MHz", cur_cpu_speed_);
+      snprintf(l, 32, "PROCS/MIN %d MHz", speed);
       legend(l);
-      drawlegend();
     }
+    _drawnstate = shownstate_;
+    drawlegend();
   }
 
   drawfields();
@@ -94,7 +114,7 @@ void LoadMeter::checkevent( void ){
 
 
 void LoadMeter::getloadinfo( void ){
-  std::ifstream loadinfo( LOADFILENAME );
+  const char *loadinfo = _loadfile.read();
 
   if ( !loadinfo ){
     std::cerr <<"Can not open file : " <<LOADFILENAME << std::endl;
@@ -102,7 +122,7 @@ void LoadMeter::getloadinfo( void ){
     return;
   }
 
-  loadinfo >> fields_[0];
+  fields_[0] = strtod(loadinfo, NULL);
 
   if ( fields_[0] <  warnThreshold ) alarmstate = 0;
   else
@@ -110,22 +130,9 @@ void LoadMeter::getloadinfo( void ){
   else
   /* if fields_[0] >= warnThreshold */ alarmstate = 1;
 
-  if ( alarmstate != lastalarmstate ){
-    if ( alarmstate == 0 ) setfieldcolor( 0, procloadcol_ );
-    else
-    if ( alarmstate == 1 ) setfieldcolor( 0, warnloadcol_ );
-    else
-    /* if alarmstate == 2 */ setfieldcolor( 0, critloadcol_ );
-    drawlegend();
-    lastalarmstate = alarmstate;
-  }
-
-  // Adjust total to next power-of-two of the current load.
-  if ( (fields_[0]*5.0 < total_ && total_ > 1.0) || fields_[0] > total_ ) {
-    unsigned int i = fields_[0];
-    i |= i >> 1; i |= i >> 2; i |= i >> 4; i |= i >> 8; i |= i >> 16;  // i = 2^n - 1
-    total_ = i + 1;
-  }
+  // By default the next power-of-two of the current load, down again
+  // once the load is under a fifth of it.
+  total_ = _autoscale.update(fields_[0], 1.0);
 
   fields_[1] = (float) (total_ - fields_[0]);
 
@@ -136,21 +143,22 @@ void LoadMeter::getloadinfo( void ){
 // (average multi-cpus on different speeds)
 // (yes - i know about devices/system/cpu/cpu*/cpufreq )
 void LoadMeter::getspeedinfo( void ){
-  std::ifstream speedinfo(SPEEDFILENAME);
-  std::string line, val;
+  const char *line = _speedfile.read();
   unsigned int total_cpu = 0, ncpus = 0;
 
-  while ( speedinfo.good() ) {
-    std::getline(speedinfo, line);
-    if ( strncmp(line.c_str(), "cpu MHz", 7) == 0 ) {
-      val = line.substr(line.find_last_of(':') + 1);
-      XOSDEBUG("SPEED: %s\n", val.c_str());
-      total_cpu += atoi(val.c_str());
-      ncpus++;
+  while ( line && *line ) {
+    if ( strncmp(line, "cpu MHz", 7) == 0 ) {
+      const char *val = strchr(line, ':');
+      if (val) {
+        XOSDEBUG("SPEED: %.*s\n", (int)strcspn(val + 1, "\n"), val + 1);
+        total_cpu += atoi(val + 1);
+        ncpus++;
+      }
     }
+    if ( (line = strchr(line, '\n')) )
+      line++;
   }
 
-  old_cpu_speed_ = cur_cpu_speed_;
   if (ncpus > 0)
     cur_cpu_speed_ = total_cpu / ncpus;
   else
@@ -12,6 +12,8 @@
 
 #include "fieldmetergraph.h"
 #include "xosview.h"
+#include "procfile.h"
+#include "autoscale.h"
 
 
 class LoadMeter : public FieldMeterGraph {
@@ -20,7 +22,9 @@ public:
   ~LoadMeter( void );
 
   const char *name( void ) const { return "LoadMeter"; }
-  void checkevent( void );
+  bool splitSample( void ) const { return true; }
+  void sample( void );
+  void render( void );
 
   void checkResources( void );
 protected:
@@ -30,9 +34,12 @@ protected:
   void getspeedinfo( void );
 
 private:
-   int warnThreshold, critThreshold, alarmstate, lastalarmstate;
-   int old_cpu_speed_, cur_cpu_speed_;
+   int warnThreshold, critThreshold, alarmstate;
+   int cur_cpu_speed_;
+   int _drawnstate;  // state_ the color and legend were last set for
    int do_cpu_speed;
+   ProcFile _loadfile, _speedfile;
+   AutoScale _autoscale;
 };
 
 
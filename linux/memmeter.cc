@@ -5,17 +5,18 @@
 //
 
 #include "memmeter.h"
+#include "decparse.h"
 #include <stdlib.h>
 // #include <stdio.h>
 #include <string.h>
-#include <fstream>
 #include <iostream>
 
 static const char MEMFILENAME[] = "/proc/meminfo";
 
 
 MemMeter::MemMeter( XOSView *parent )
-: FieldMeterGraph( parent, 6, "MEM", "USED/BUFF/SLAB/MAP/CACHE/FREE" ){
+: FieldMeterGraph( parent, 6, "MEM", "USED/BUFF/SLAB/MAP/CACHE/FREE" ),
+  _meminfo(MEMFILENAME) {
   _MIlineInfos = NULL;
   initLineInfo();
 }
@@ -34,12 +35,12 @@ void MemMeter::checkResources( void ){
   setfieldcolor( 4, parent_->getResource( "memCacheColor" ) );
   setfieldcolor( 5, parent_->getResource( "memFreeColor" ) );
   priority_ = atoi (parent_->getResource( "memPriority" ) );
-  dodecay_ = parent_->isResourceTrue( "memDecay" );
+  useDecay( "memDecay" );
   useGraph_ = parent_->isResourceTrue( "memGraph" );
   SetUsedFormat (parent_->getResource("memUsedFormat"));
 }
 
-void MemMeter::checkevent( void ){
+void MemMeter::sample( void ){
   getmeminfo();
   /* for debugging (see below)
   printf("t %4.1f used %4.1f buffer %4.1f slab %4.1f map %4.1f cache %4.1f free %4.1f\n",
@@ -48,14 +49,13 @@ void MemMeter::checkevent( void ){
 	 fields_[2]/1024.0/1024.0, fields_[3]/1024.0/1024.0,
 	 fields_[4]/1024.0/1024.0, fields_[5]/1024.0/1024.0);
   */
-  drawfields();
 }
 
 // FIXME: /proc/memstat and /proc/meminfo don't seem to correspond
 // maybe it is time to fix this in the kernel and get real infos ...
 
 void MemMeter::getmeminfo( void ){
-  getmemstat(MEMFILENAME, _MIlineInfos, _numMIlineInfos);
+  getmemstat(_meminfo, _MIlineInfos, _numMIlineInfos);
   fields_[4] -= fields_[3]; // mapped comes from cache
   fields_[0] = total_ - fields_[5] - fields_[4] - fields_[3] - fields_[2] - fields_[1];
 
@@ -64,22 +64,19 @@ void MemMeter::getmeminfo( void ){
 }
 
 MemMeter::LineInfo *MemMeter::findLines(LineInfo *tmplate, int len,
-                                             const char *fname){
-  std::ifstream meminfo(fname);
-  if (!meminfo){
-    std::cerr << "Can not open file : " << fname << std::endl;
+                                             ProcFile &file){
+  const char *buf = file.read();
+  if (!buf){
+    std::cerr << "Can not open file : " << file.filename() << std::endl;
     exit(1);
   }
 
   LineInfo *rval = new LineInfo[len];
 
-  char buf[256];
-
   // Get the info from the "standard" meminfo file.
   int lineNum = 0;
   int inum = 0;  // which info are we going to insert
-  while (!meminfo.eof()){
-    meminfo.getline(buf, 256);
+  while (buf && *buf){
     lineNum++;
 
     for (int i = 0 ; i < len ; i++)
@@ -88,6 +85,9 @@ MemMeter::LineInfo *MemMeter::findLines(LineInfo *tmplate, int len,
         rval[inum].line(lineNum);
         inum++;
       }
+
+    if ( (buf = strchr(buf, '\n')) )
+      buf++;
   }
 
   return rval;
@@ -104,27 +104,28 @@ void MemMeter::initLineInfo(void){
   };
   _numMIlineInfos = sizeof(infos) / sizeof(LineInfo);
 
-  _MIlineInfos = findLines(infos, _numMIlineInfos, MEMFILENAME);
+  _MIlineInfos = findLines(infos, _numMIlineInfos, _meminfo);
 }
 
-void MemMeter::getmemstat(const char *fname, LineInfo *infos, int ninfos){
-  std::ifstream meminfo(fname);
-  if (!meminfo){
-    std::cerr << "Can not open file : " << fname << std::endl;
+void MemMeter::getmemstat(ProcFile &file, LineInfo *infos, int ninfos){
+  const char *buf = file.read();
+  if (!buf){
+    std::cerr << "Can not open file : " << file.filename() << std::endl;
     exit(1);
   }
 
   // Get the info from the "standard" meminfo file.
   int lineNum = 0, inum = 0;
   unsigned long long val;
-  char buf[256];
-  while (inum < ninfos && !meminfo.eof()){
-    meminfo.getline(buf, 256);
-    if (++lineNum != infos[inum].line())
-      continue;
-
-    val = strtoull(buf + infos[inum].idlen() + 1, NULL, 10);
-    /*  All stats are in KB.  */
-    infos[inum++].setVal((double)(val<<10));	/*  Multiply by 1024 bytes per K  */
+  while (inum < ninfos && buf && *buf){
+    if (++lineNum == infos[inum].line()){
+      if ( !decparse(buf + infos[inum].idlen() + 1, &val) )
+        val = 0;
+      /*  All stats are in KB.  */
+      infos[inum++].setVal((double)(val<<10));	/*  Multiply by 1024 bytes per K  */
+    }
+
+    if ( (buf = strchr(buf, '\n')) )
+      buf++;
   }
 }
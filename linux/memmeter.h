@@ -9,6 +9,7 @@
 
 #include "fieldmetergraph.h"
 #include "xosview.h"
+#include "procfile.h"
 #include <string.h>
 
 
@@ -18,7 +19,8 @@ public:
   ~MemMeter( void );
 
   const char *name( void ) const { return "MemMeter"; }
-  void checkevent( void );
+  bool splitSample( void ) const { return true; }
+  void sample( void );
 
   void checkResources( void );
 protected:
@@ -47,10 +49,11 @@ private:
 
   LineInfo *_MIlineInfos;
   int _numMIlineInfos;
+  ProcFile _meminfo;
 
   void initLineInfo(void);
-  LineInfo *findLines(LineInfo *tmplate, int len, const char *fname);
-  void getmemstat(const char *fname, LineInfo *infos, int ninfos);
+  LineInfo *findLines(LineInfo *tmplate, int len, ProcFile &file);
+  void getmemstat(ProcFile &file, LineInfo *infos, int ninfos);
 };
 
 
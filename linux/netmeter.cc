@@ -8,13 +8,19 @@
 //
 
 #include "netmeter.h"
+#include "decparse.h"
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+#include <unistd.h>
 #include <dirent.h>
+#include <errno.h>
 #include <string.h>
 #include <stdlib.h>
 #include <iostream>
-#include <fstream>
 #include <string>
 
 static const char PROCNETDEV[] = "/proc/net/dev";
@@ -22,17 +28,24 @@ static const char SYSCLASSNET[] = "/sys/class/net";
 
 
 NetMeter::NetMeter( XOSView *parent, float max )
-  : FieldMeterGraph( parent, 3, "NET", "IN/OUT/IDLE" ){
+  : FieldMeterGraph( parent, 3, "NET", "IN/OUT/IDLE" ),
+  _procnetdev(PROCNETDEV), _rtnlseq(0), _rtnlbuf(32768), _bytes(2) {
   _maxpackets = max;
-  _lastBytesIn = _lastBytesOut = 0;
   _usesysfs = _ignored = false;
 
+  // One RTM_GETLINK dump gets the counters of all interfaces at once.
+  _rtnl = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+
   struct stat buf;
   if ( stat(SYSCLASSNET, &buf) == 0 && S_ISDIR(buf.st_mode) )
     _usesysfs = true;
 }
 
 NetMeter::~NetMeter( void ){
+  for (SysFiles::iterator it = _sysfiles.begin(); it != _sysfiles.end(); ++it)
+    delete it->second;
+  if (_rtnl >= 0)
+    close(_rtnl);
 }
 
 void NetMeter::checkResources( void ){
@@ -43,58 +56,164 @@ void NetMeter::checkResources( void ){
   setfieldcolor( 2, parent_->getResource( "netBackground" ) );
   priority_ = atoi( parent_->getResource( "netPriority" ) );
   useGraph_ = parent_->isResourceTrue( "netGraph" );
-  dodecay_ = parent_->isResourceTrue( "netDecay" );
+  useDecay( "netDecay" );
   SetUsedFormat( parent_->getResource("netUsedFormat") );
   _netIface = parent_->getResource( "netIface" );
+  _autoscale.configure(parent_, "net");
   if (_netIface[0] == '-') {
     _ignored = true;
     _netIface.erase(0, _netIface.find_first_not_of("- "));
   }
 }
 
-void NetMeter::checkevent( void ){
-  unsigned long long totin = 0, totout = 0;
-  fields_[2] = _maxpackets;     // assume no
-  fields_[0] = fields_[1] = 0;  // network activity
+void NetMeter::sample( void ){
+  unsigned long long tot[2] = { 0, 0 };  // in, out
 
-  IntervalTimerStop();
-  if (_usesysfs)
-    getSysStats(totin, totout);
+  if (_rtnl >= 0 && getNetlinkStats(tot[0], tot[1]))
+    ;
+  else if (_usesysfs)
+    getSysStats(tot[0], tot[1]);
   else
-    getProcStats(totin, totout);
+    getProcStats(tot[0], tot[1]);
 
-  double t = IntervalTimeInSecs();
-  IntervalTimerStart();
+  //  An interface going away takes its bytes out of the totals, which
+  //  counts as a reset rather than a huge rate.
+  _bytes.update(tot);
+  fields_[0] = _bytes.rate(0);
+  fields_[1] = _bytes.rate(1);
 
-  if (_lastBytesIn == 0 && _lastBytesOut == 0) {  // first run
-    _lastBytesIn = totin;
-    _lastBytesOut = totout;
-  }
+  // at least netBandwidth, more after a burst
+  total_ = _autoscale.update(fields_[0] + fields_[1], _maxpackets);
+  fields_[2] = total_ - fields_[0] - fields_[1];
+
+  setUsed(fields_[0] + fields_[1], total_);
+}
 
-  fields_[0] = (totin - _lastBytesIn) / t;
-  fields_[1] = (totout - _lastBytesOut) / t;
+bool NetMeter::skipIface( const char *name ) const {
+  if (_netIface == "False")
+    return false;
+  return ( (!_ignored && name != _netIface) ||
+           ( _ignored && name == _netIface) );
+}
+
+// Sum the byte counters of all links from one RTM_GETLINK dump.  On any
+// error the socket is closed and the caller falls back to sysfs/proc.
+bool NetMeter::getNetlinkStats( unsigned long long &totin, unsigned long long &totout ){
+  struct {
+    struct nlmsghdr nlh;
+    struct ifinfomsg ifm;
+  } req;
+  unsigned long long in = 0, out = 0;
+
+  memset(&req, 0, sizeof(req));
+  req.nlh.nlmsg_len = NLMSG_LENGTH(sizeof(req.ifm));
+  req.nlh.nlmsg_type = RTM_GETLINK;
+  req.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+  req.nlh.nlmsg_seq = ++_rtnlseq;
+  req.ifm.ifi_family = AF_UNSPEC;
 
-  _lastBytesIn = totin;
-  _lastBytesOut = totout;
+  if (send(_rtnl, &req, req.nlh.nlmsg_len, 0) < 0)
+    goto fail;
 
-  total_ = fields_[0] + fields_[1];
-  if (total_ > _maxpackets)
-    fields_[2] = 0;
-  else {
-    total_ = _maxpackets;
-    fields_[2] = total_ - fields_[0] - fields_[1];
+  for (;;) {
+    ssize_t len = recv(_rtnl, &_rtnlbuf[0], _rtnlbuf.size(), 0);
+    if (len < 0) {
+      if (errno == EINTR)
+        continue;
+      goto fail;
+    }
+
+    for (struct nlmsghdr *nlh = (struct nlmsghdr *)&_rtnlbuf[0];
+         NLMSG_OK(nlh, (unsigned int)len); nlh = NLMSG_NEXT(nlh, len)) {
+      if (nlh->nlmsg_seq != _rtnlseq)
+        continue;  // left over from an earlier, failed dump
+      if (nlh->nlmsg_type == NLMSG_DONE) {
+        totin += in;
+        totout += out;
+        return true;
+      }
+      if (nlh->nlmsg_type == NLMSG_ERROR)
+        goto fail;
+      if (nlh->nlmsg_type != RTM_NEWLINK)
+        continue;
+
+      struct ifinfomsg *ifm = (struct ifinfomsg *)NLMSG_DATA(nlh);
+      int alen = IFLA_PAYLOAD(nlh);
+      const char *name = NULL;
+      struct rtnl_link_stats64 stats64;
+      bool have64 = false, have32 = false;
+      struct rtnl_link_stats stats32;
+
+      for (struct rtattr *rta = IFLA_RTA(ifm); RTA_OK(rta, alen);
+           rta = RTA_NEXT(rta, alen)) {
+        if (rta->rta_type == IFLA_IFNAME)
+          name = (const char *)RTA_DATA(rta);
+        else if (rta->rta_type == IFLA_STATS64 &&
+                 RTA_PAYLOAD(rta) >= sizeof(stats64)) {
+          memcpy(&stats64, RTA_DATA(rta), sizeof(stats64));  // may be unaligned
+          have64 = true;
+        }
+        else if (rta->rta_type == IFLA_STATS &&
+                 RTA_PAYLOAD(rta) >= sizeof(stats32)) {
+          memcpy(&stats32, RTA_DATA(rta), sizeof(stats32));
+          have32 = true;
+        }
+      }
+      if (!name || skipIface(name))
+        continue;
+
+      if (have64) {
+        in += stats64.rx_bytes;
+        out += stats64.tx_bytes;
+      }
+      else if (have32) {
+        in += stats32.rx_bytes;
+        out += stats32.tx_bytes;
+      }
+      XOSDEBUG("%s: netlink %s\n", name, have64 ? "stats64" : "stats");
+    }
   }
 
-  setUsed(fields_[0] + fields_[1], total_);
-  drawfields();
+ fail:
+  XOSDEBUG("rtnetlink failed (errno %d), using %s\n", errno,
+           _usesysfs ? SYSCLASSNET : PROCNETDEV);
+  close(_rtnl);
+  _rtnl = -1;
+  return false;
+}
+
+//  The file is kept open from the last pass if it was read then, and
+//  goes into seen for the next one.  False if it can not be read, as
+//  when the interface went away since the directory was read.
+bool NetMeter::readSysValue( const char *filename, unsigned long long &value,
+                             SysFiles &seen ){
+  ProcFile *&file = seen[filename];
+  if (!file) {
+    SysFiles::iterator it = _sysfiles.find(filename);
+    if (it != _sysfiles.end()) {
+      file = it->second;
+      _sysfiles.erase(it);
+    }
+    else
+      file = new ProcFile(filename);
+  }
+
+  const char *buf = file->read();
+  if (!buf) {
+    XOSDEBUG("Can not read %s\n", filename);
+    return false;
+  }
+  if ( !decparse(buf, &value) )
+    value = 0;
+  return true;
 }
 
 void NetMeter::getSysStats( unsigned long long &totin, unsigned long long &totout ){
   DIR *dir;
   struct dirent *ent;
   char filename[128];
-  std::ifstream ifs;
-  unsigned long long value;
+  unsigned long long in, out;
+  SysFiles seen;
 
   if ( !(dir = opendir(SYSCLASSNET)) ) {
     std::cerr << "Can not open directory : " << SYSCLASSNET << std::endl;
@@ -107,76 +226,64 @@ void NetMeter::getSysStats( unsigned long long &totin, unsigned long long &totou
     if ( !strncmp(ent->d_name, ".", 1) ||
          !strncmp(ent->d_name, "..", 2) )
       continue;
-    if ( _netIface != "False" &&
-         ( (!_ignored && ent->d_name != _netIface) ||
-           ( _ignored && ent->d_name == _netIface) ) )
+    if ( skipIface(ent->d_name) )
         continue;
 
     snprintf(filename, 128, "%s/%s/statistics/rx_bytes", SYSCLASSNET, ent->d_name);
-    ifs.open(filename);
-    if ( !ifs.good() ) {
-      std::cerr << "Can not open file : " << filename << std::endl;
-      parent_->done(1);
-      return;
-    }
-    ifs >> value;
-    ifs.close();
-    totin += value;
-    XOSDEBUG("%s: %llu bytes received", ent->d_name, value);
-
+    if ( !readSysValue(filename, in, seen) )
+      continue;
     snprintf(filename, 128, "%s/%s/statistics/tx_bytes", SYSCLASSNET, ent->d_name);
-    ifs.open(filename);
-    if ( !ifs.good() ) {
-      std::cerr << "Can not open file : " << filename << std::endl;
-      parent_->done(1);
-      return;
-    }
-    ifs >> value;
-    ifs.close();
-    totout += value;
-    XOSDEBUG(", %llu bytes sent.\n", value);
+    if ( !readSysValue(filename, out, seen) )
+      continue;
+    totin += in;
+    totout += out;
+    XOSDEBUG("%s: %llu bytes received, %llu bytes sent.\n",
+             ent->d_name, in, out);
   }
   closedir(dir);
+
+  //  The interfaces that are gone (veth pairs of containers come and go
+  //  all the time) take their files with them.
+  for (SysFiles::iterator it = _sysfiles.begin(); it != _sysfiles.end(); ++it)
+    delete it->second;
+  _sysfiles.swap(seen);
 }
 
 void NetMeter::getProcStats( unsigned long long &totin, unsigned long long &totout ){
-  std::ifstream ifs(PROCNETDEV);
-  std::string line, ifname;
+  const char *line = _procnetdev.read();
 
-  if (!ifs) {
+  if (!line) {
     std::cerr << "Can not open file : " << PROCNETDEV << std::endl;
     parent_->done(1);
     return;
   }
 
-  ifs.ignore(1024, '\n');
-  ifs.ignore(1024, '\n');
+  // skip the two header lines
+  for (int i = 0; i < 2 && line; i++)
+    if ( (line = strchr(line, '\n')) )
+      line++;
 
-  while ( !ifs.eof() ) {
+  while ( line && *line ) {
     unsigned long long vals[9];
-    std::getline(ifs, line);
-    if ( !ifs.good() )
+    const char *colon = strchr(line, ':');
+    if (!colon)
       break;
 
-    int colon = line.find_first_of(':');
-    ifname = line.substr(0, colon);
-    ifname.erase(0, ifname.find_first_not_of(' '));
-    if (_netIface != "False") {
-      if ( (!_ignored && ifname != _netIface) ||
-           ( _ignored && ifname == _netIface) )
-        continue;
-    }
+    line += strspn(line, " ");
+    std::string ifname(line, colon - line);
+    line = strchr(colon, '\n');
+    if (line)
+      line++;
 
-    std::string l = line.erase(0, colon + 1);
-    const char *cur = l.c_str();
+    if ( skipIface(ifname.c_str()) )
+      continue;
+
+    const char *cur = colon + 1;
     if ( strncmp(cur, " No ", 4) == 0 )
       continue; // xxx: No statistics available.
 
-    char *end = NULL;
-    for (int i = 0; i < 9; i++) {
-      vals[i] = strtoull(cur, &end, 10);
-      cur = end;
-    }
+    if ( decparse(cur, vals, 9, &cur) < 9 )
+      continue;
     totin += vals[0];
     totout += vals[8];
     XOSDEBUG("%s: %llu bytes received, %llu bytes sent.\n",
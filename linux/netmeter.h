@@ -9,7 +9,12 @@
 
 #include "fieldmetergraph.h"
 #include "xosview.h"
+#include "procfile.h"
+#include "counterrates.h"
+#include "autoscale.h"
 #include <string>
+#include <map>
+#include <vector>
 
 
 class NetMeter : public FieldMeterGraph {
@@ -18,16 +23,28 @@ public:
   ~NetMeter( void );
 
   const char *name( void ) const { return "NetMeter"; }
-  void checkevent( void );
+  bool splitSample( void ) const { return true; }
+  void sample( void );
   void checkResources( void );
 
 private:
+  bool getNetlinkStats( unsigned long long &totin, unsigned long long &totout );
   void getProcStats( unsigned long long &totin, unsigned long long &totout );
   void getSysStats( unsigned long long &totin, unsigned long long &totout );
+  typedef std::map<std::string, ProcFile *> SysFiles;
+  bool readSysValue( const char *filename, unsigned long long &value,
+                     SysFiles &seen );
+  bool skipIface( const char *name ) const;
   float _maxpackets;
   std::string _netIface;
   bool _usesysfs, _ignored;
-  unsigned long long _lastBytesIn, _lastBytesOut;
+  ProcFile _procnetdev;
+  SysFiles _sysfiles;        // of the interfaces seen on the last pass
+  int _rtnl;                // rtnetlink socket, -1 if not usable
+  unsigned int _rtnlseq;
+  std::vector<char> _rtnlbuf;
+  CounterRates _bytes;      // in, out
+  AutoScale _autoscale;
 };
 
 
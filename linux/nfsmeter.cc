@@ -10,19 +10,21 @@
 #include "nfsmeter.h"
 #include <string.h>
 #include <stdio.h>
-#include <fstream>
 // #include <iostream>
 
 #ifndef MAX
 #define MAX(_a, _b) ((_a) > (_b) ? (_a) : (_b))
 #endif
 
+//  The kernel keeps these counters in 32 bits.
+static const int NFSCOUNTERBITS = 32;
+
 static const char *NFSSVCSTAT = "/proc/net/rpc/nfsd";
 static const char * NFSCLTSTAT = "/proc/net/rpc/nfs";
 
 NFSMeter::NFSMeter(XOSView *parent, const char *name, int nfields,
 		const char *fields, const char *statfile)
-  : FieldMeterGraph( parent, nfields, name, fields ){
+  : FieldMeterGraph( parent, nfields, name, fields ), _file(statfile){
 	_statfile = statfile;
 	_statname = name;
 }
@@ -35,8 +37,8 @@ void NFSMeter::checkResources( void ){
 }
 
 NFSDStats::NFSDStats(XOSView *parent)
-  : NFSMeter(parent, "NFSD", 4, "BAD/UDP/TCP/IDLE", NFSSVCSTAT ){
-	starttimer();
+  : NFSMeter(parent, "NFSD", 4, "BAD/UDP/TCP/IDLE", NFSSVCSTAT ),
+    _counts(4, NFSCOUNTERBITS){
 }
 
 NFSDStats::~NFSDStats( void ) {
@@ -51,58 +53,46 @@ void NFSDStats::checkResources( void ){
   setfieldcolor( 3, parent_->getResource( "NFSDStatIdleColor" ) );
 
   useGraph_ = parent_->isResourceTrue( "NFSDStatGraph" );
-  dodecay_ = parent_->isResourceTrue( "NFSDStatDecay" );
+  useDecay( "NFSDStatDecay" );
   SetUsedFormat (parent_->getResource("NFSDStatUsedFormat"));
   //useGraph_ = 1;
   //dodecay_ = 1;
   //SetUsedFormat ("autoscale");
   //SetUsedFormat ("percent");
 }
-void NFSDStats::checkevent(void)
+void NFSDStats::sample(void)
 {
-	char buf[4096], name[64];
-	unsigned long netcnt, netudpcnt, nettcpcnt, nettcpconn;
-	unsigned long calls, badcalls;
-	int found;
-
-    std::ifstream ifs(_statfile);
+	unsigned long netcnt = 0, netudpcnt = 0, nettcpcnt = 0, nettcpconn = 0;
+	unsigned long calls = 0, badcalls = 0;
+	unsigned long long counts[4];
+	const char *line;
 
-    if (!ifs) {
+    if (!_file.read()) {
         // cerr <<"Can not open file : " <<_statfile <<endl;
         // parent_->done(1);
         return;
 	}
 
 	fields_[0] = fields_[1] = fields_[2] = 0;  // network activity
-    stoptimer();
-
-	name[0] = '\0';
-	found = 0;
-	while (!ifs.eof() && found != 2) {
-		ifs.getline(buf, 4096, '\n');
-		if (strncmp("net", buf, strlen("net")) == 0) {
-			sscanf(buf, "%s %lu %lu %lu %lu\n", name,
-				&netcnt, &netudpcnt, &nettcpcnt, &nettcpconn);
-			found++;
-		}
-		if (strncmp("rpc", buf, strlen("rpc")) == 0) {
-			sscanf(buf, "%s %lu %lu\n", name, &calls, &badcalls);
-			found++;
-		}
-	}
 
-    float t = 1000000.0 / usecs();
+	if ((line = _file.find("net")))
+		sscanf(line, "%lu %lu %lu %lu", &netcnt, &netudpcnt, &nettcpcnt,
+			&nettcpconn);
+	if ((line = _file.find("rpc")))
+		sscanf(line, "%lu %lu", &calls, &badcalls);
 
-    if (t < 0)
-        t = 0.1;
+	counts[0] = badcalls;
+	counts[1] = netudpcnt;
+	counts[2] = nettcpcnt;
+	counts[3] = MAX(netcnt, calls);
+	_counts.update(counts);
 
-	maxpackets_ = MAX(netcnt, calls) - _lastNetCnt;
+	maxpackets_ = _counts.delta(3);
 	if (maxpackets_ == 0) {
 		maxpackets_ = netcnt;
 	} else {
-		fields_[0] = (badcalls - _lastBad) * t;
-		fields_[1] = (netudpcnt - _lastUdp) * t;
-		fields_[2] = (nettcpcnt - _lastTcp) * t;
+		for (int i = 0; i < 3; i++)
+			fields_[i] = _counts.rate(i);
 	}
 
     total_ = fields_[0] + fields_[1] + fields_[2];
@@ -115,19 +105,11 @@ void NFSDStats::checkevent(void)
 
     if (total_)
         setUsed(fields_[0] + fields_[1] + fields_[2], total_);
-
-    starttimer();
-    drawfields();
-
-	_lastNetCnt = MAX(netcnt, calls);
-    _lastTcp = nettcpcnt;
-    _lastUdp = netudpcnt;
-    _lastBad = badcalls;
 }
 
 NFSStats::NFSStats(XOSView *parent)
-  : NFSMeter(parent, "NFS", 4, "RETRY/AUTH/CALL/IDLE", NFSCLTSTAT ){
-	starttimer();
+  : NFSMeter(parent, "NFS", 4, "RETRY/AUTH/CALL/IDLE", NFSCLTSTAT ),
+    _counts(3, NFSCOUNTERBITS){
 }
 
 NFSStats::~NFSStats( void ) {
@@ -142,49 +124,40 @@ void NFSStats::checkResources( void ){
   setfieldcolor( 3, parent_->getResource( "NFSStatIdleColor" ) );
 
   useGraph_ = parent_->isResourceTrue( "NFSStatGraph" );
-  dodecay_ = parent_->isResourceTrue( "NFSStatDecay" );
+  useDecay( "NFSStatDecay" );
   SetUsedFormat (parent_->getResource("NFSStatUsedFormat"));
   //SetUsedFormat ("autoscale");
   //SetUsedFormat ("percent");
 }
 
-void NFSStats::checkevent(void)
+void NFSStats::sample(void)
 {
-	char buf[4096], name[64];
 	unsigned long calls = 0, retrns = 0, authrefresh = 0, maxpackets_;
+	unsigned long long counts[3];
+	const char *line;
 
-    std::ifstream ifs(_statfile);
-
-    if (!ifs) {
+    if (!_file.read()) {
         // cerr <<"Can not open file : " <<_statfile <<endl;
         // parent_->done(1);
         return;
 	}
 
 	fields_[0] = fields_[1] = fields_[2] = 0;
-    stoptimer();
-
-	name[0] = '\0';
-	while (!ifs.eof()) {
-		ifs.getline(buf, 4096, '\n');
-		if (strncmp("rpc", buf, strlen("rpc")))
-			continue;
-		sscanf(buf, "%s %lu %lu %lu\n", name, &calls, &retrns, &authrefresh);
-		break;
-	}
 
-    float t = 1000000.0 / usecs();
+	if ((line = _file.find("rpc")))
+		sscanf(line, "%lu %lu %lu", &calls, &retrns, &authrefresh);
 
-    if (t < 0)
-        t = 0.1;
+	counts[0] = retrns;
+	counts[1] = authrefresh;
+	counts[2] = calls;
+	_counts.update(counts);
 
-	maxpackets_ = calls - _lastcalls;
+	maxpackets_ = _counts.delta(2);
 	if (maxpackets_ == 0) {
 		maxpackets_ = calls;
 	} else {
-		fields_[2] = (calls - _lastcalls) * t;
-		fields_[1] = (authrefresh - _lastauthrefresh) * t;
-		fields_[0] = (retrns - _lastretrns) * t;
+		for (int i = 0; i < 3; i++)
+			fields_[i] = _counts.rate(i);
 	}
 
     total_ = fields_[0] + fields_[1] + fields_[2];
@@ -197,11 +170,4 @@ void NFSStats::checkevent(void)
 
     if (total_)
         setUsed(fields_[0] + fields_[1] + fields_[2], total_);
-
-    starttimer();
-    drawfields();
-
-	_lastcalls = calls;
-	_lastretrns = retrns;
-	_lastauthrefresh = authrefresh;
 }
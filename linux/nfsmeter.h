@@ -8,7 +8,8 @@
 
 #include "fieldmetergraph.h"
 #include "xosview.h"
-#include "timer.h"
+#include "procfile.h"
+#include "counterrates.h"
 
 
 class NFSMeter : public FieldMeterGraph {
@@ -22,18 +23,13 @@ public:
   ~NFSMeter( void );
 
   const char *name( void ) const { return _statname; }
+  bool splitSample( void ) const { return true; }
   void checkResources( void );
-  void starttimer(void) { return _timer.start(); };
-  void stoptimer(void) { return _timer.stop(); };
-  double usecs(void) { return _timer.report_usecs(); };
 
 protected:
   const char *_statname;
   const char *_statfile;
-
-private:
-  Timer _timer;
-
+  ProcFile _file;
 };
 
 class NFSStats : public NFSMeter {
@@ -41,11 +37,11 @@ public:
   NFSStats(XOSView *parent);
   ~NFSStats(void);
 
-  void checkevent( void );
+  void sample( void );
 
   void checkResources( void );
 private:
-	unsigned long _lastcalls, _lastretrns, _lastauthrefresh;
+	CounterRates _counts;  // retrans, authrefresh, calls
 };
 
 class NFSDStats : public NFSMeter {
@@ -53,7 +49,7 @@ public:
   NFSDStats(XOSView *parent);
   ~NFSDStats(void);
 
-  void checkevent( void );
+  void sample( void );
 
   void checkResources( void );
 
@@ -61,7 +57,7 @@ protected:
   float maxpackets_;
 
 private:
-  unsigned long _lastTcp, _lastUdp, _lastNetCnt, _lastBad;
+  CounterRates _counts;  // bad calls, udp, tcp, packets or calls
 };
 
 #endif
@@ -5,25 +5,20 @@
 //
 
 #include "pagemeter.h"
+#include "procstat.h"
 #include <stdlib.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <string.h>
-#include <fstream>
 #include <iostream>
 
-#define MAX_PROCSTAT_LENGTH 4096
-
 
 PageMeter::PageMeter( XOSView *parent, float max )
   : FieldMeterGraph( parent, 3, "PAGE", "IN/OUT/IDLE" ),
-  _vmstat(false), _statFileName("/proc/stat"){
-  for ( int i = 0 ; i < 2 ; i++ )
-    for ( int j = 0 ; j < 2 ; j++ )
-      pageinfo_[j][i] = 0;
-
+  _vmstat(false), _statFileName("/proc/stat"),
+  pages_(2, 8 * sizeof(unsigned long)){
+  pageinfo_[0] = pageinfo_[1] = 0;
   maxspeed_ = max;
-  pageindex_ = 0;
 
   struct stat buf;
   if (stat("/proc/vmstat", &buf) == 0
@@ -31,6 +26,7 @@ PageMeter::PageMeter( XOSView *parent, float max )
       {
       _vmstat = true;
       _statFileName = "/proc/vmstat";
+      _vmstatfile.filename(_statFileName);
       }
 }
 
@@ -45,28 +41,25 @@ void PageMeter::checkResources( void ){
   setfieldcolor( 2, parent_->getResource( "pageIdleColor" ) );
   priority_ = atoi (parent_->getResource( "pagePriority" ) );
   maxspeed_ *= priority_ / 10.0;
-  dodecay_ = parent_->isResourceTrue( "pageDecay" );
+  useDecay( "pageDecay" );
   useGraph_ = parent_->isResourceTrue( "pageGraph" );
   SetUsedFormat (parent_->getResource("pageUsedFormat"));
 }
 
-void PageMeter::checkevent( void ){
+void PageMeter::sample( void ){
  if (_vmstat)
      getvmpageinfo();
  else
      getpageinfo();
- drawfields();
 }
 
 void PageMeter::updateinfo(void)
     {
-    int oldindex = (pageindex_+1)%2;
+    pages_.update(pageinfo_);
     for ( int i = 0; i < 2; i++ )
         {
-        if ( pageinfo_[oldindex][i] == 0 )
-            pageinfo_[oldindex][i] = pageinfo_[pageindex_][i];
-
-        fields_[i] = pageinfo_[pageindex_][i] - pageinfo_[oldindex][i];
+        // per sample period, also when sampling was slowed down
+        fields_[i] = pages_.delta(i) / (double)periods_;
         total_ += fields_[i];
         }
 
@@ -79,52 +72,35 @@ void PageMeter::updateinfo(void)
         }
 
     setUsed (total_ - fields_[2], maxspeed_);
-    pageindex_ = (pageindex_ + 1) % 2;
     }
 
 void PageMeter::getvmpageinfo(void)
     {
     total_ = 0;
-    char buf[MAX_PROCSTAT_LENGTH];
-    bool found_in = false, found_out = false;
-    std::ifstream stats(_statFileName);
-    if (!stats)
+    const char *val;
+    if (!_vmstatfile.read())
         {
         std::cerr <<"Cannot open file : " << _statFileName << std::endl;
         exit(1);
         }
-    while (!stats.eof() && !(found_in && found_out))
-        {
-        stats.getline(buf, MAX_PROCSTAT_LENGTH);
-        if (!strncmp(buf, "pswpin", 6))
-            {
-            pageinfo_[pageindex_][0] = strtoul(buf+7, NULL, 10);
-            found_in = true;
-            }
-        if (!strncmp(buf, "pswpout", 7))
-            {
-            pageinfo_[pageindex_][1] = strtoul(buf+8, NULL, 10);
-            found_out = true;
-            }
-        }
+    if ((val = _vmstatfile.find("pswpin")))
+        pageinfo_[0] = strtoul(val, NULL, 10);
+    if ((val = _vmstatfile.find("pswpout")))
+        pageinfo_[1] = strtoul(val, NULL, 10);
     updateinfo();
     }
 
 void PageMeter::getpageinfo( void ){
   total_ = 0;
-  char buf[MAX_PROCSTAT_LENGTH];
-  std::ifstream stats(_statFileName);
-
-  if ( !stats ){
-    std::cerr <<"Cannot open file : " << _statFileName << std::endl;
-    exit( 1 );
+  ProcStat &stat = ProcStat::instance();
+  stat.update(parent_->tick());
+
+  const char *swap = stat.find("swap");
+  if (swap) {
+    char *end = NULL;
+    pageinfo_[0] = strtoul(swap, &end, 10);
+    pageinfo_[1] = strtoul(end, NULL, 10);
   }
 
-  do {
-    stats >>buf;
-  } while (!stats.eof() && strncasecmp(buf, "swap", 5));
-
-  stats >>pageinfo_[pageindex_][0] >>pageinfo_[pageindex_][1];
-
   updateinfo();
 }
@@ -9,6 +9,8 @@
 
 #include "fieldmetergraph.h"
 #include "xosview.h"
+#include "procfile.h"
+#include "counterrates.h"
 
 
 class PageMeter : public FieldMeterGraph {
@@ -17,15 +19,17 @@ public:
   ~PageMeter( void );
 
   const char *name( void ) const { return "PageMeter"; }
-  void checkevent( void );
+  bool splitSample( void ) const { return true; }
+  void sample( void );
 
   void checkResources( void );
 protected:
-  unsigned long pageinfo_[2][2];
-  int pageindex_;
+  unsigned long long pageinfo_[2];  // pages swapped in, out
   float maxspeed_;
   bool _vmstat;
   const char *_statFileName;
+  ProcFile _vmstatfile;
+  CounterRates pages_;
 
   void getpageinfo( void );
   void getvmpageinfo( void );
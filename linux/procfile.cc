@@ -0,0 +1,122 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#include "procfile.h"
+#include "xosview.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <string.h>
+
+#define INITIAL_SIZE 256
+
+unsigned long ProcFile::_syscalls = 0;
+__thread unsigned long ProcFile::_tickSyscalls = 0;
+__thread unsigned long ProcFile::_lastTickSyscalls = 0;
+__thread unsigned long ProcFile::_tick = 0;
+const XOSView *ProcFile::_xos = NULL;
+
+
+ProcFile::ProcFile( const char *filename )
+  : _buf(INITIAL_SIZE), _len(0), _fd(-1) {
+  if (filename)
+    _filename = filename;
+}
+
+ProcFile::~ProcFile( void ){
+  close();
+}
+
+void ProcFile::filename( const char *filename ){
+  if (_filename == filename)
+    return;
+  close();
+  _filename = filename;
+}
+
+char *ProcFile::read( void ){
+  count();
+
+  //  One retry with a fresh descriptor covers files that were
+  //  removed and recreated since the last read.
+  if ( (_fd >= 0 && pread()) || (reopen() && pread()) )
+    return &_buf[0];
+
+  close();
+  _len = 0;
+  _buf[0] = '\0';
+  return NULL;
+}
+
+const char *ProcFile::find( const char *key ) const {
+  int len = strlen(key);
+  const char *cur = &_buf[0];
+
+  while (*cur) {
+    if (!strncmp(cur, key, len) && (cur[len] == ' ' || cur[len] == '\t'))
+      return cur + len;
+    if ( !(cur = strchr(cur, '\n')) )
+      break;
+    cur++;
+  }
+  return NULL;
+}
+
+bool ProcFile::pread( void ){
+  _len = 0;
+  for (;;) {
+    counted();
+    ssize_t n = ::pread(_fd, &_buf[_len], _buf.size() - _len - 1, _len);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    if (n == 0)
+      break;
+    _len += n;
+    //  A short read is not the end: procfs seq_files hand over at most
+    //  about a page of whole lines a read.  Only a read of 0 is.
+    if (_len + 1 == _buf.size())
+      _buf.resize(2 * _buf.size());
+  }
+  _buf[_len] = '\0';
+  return true;
+}
+
+bool ProcFile::reopen( void ){
+  close();
+  if (_filename.empty())
+    return false;
+  counted();
+  _fd = open(_filename.c_str(), O_RDONLY | O_CLOEXEC);
+  return _fd >= 0;
+}
+
+void ProcFile::close( void ){
+  if (_fd < 0)
+    return;
+  counted();
+  ::close(_fd);
+  _fd = -1;
+}
+
+//  The meters of the sampler thread read their files at the same time
+//  as the others.
+void ProcFile::counted( void ){
+  __atomic_add_fetch(&_syscalls, 1, __ATOMIC_RELAXED);
+  _tickSyscalls++;
+}
+
+void ProcFile::count( void ){
+  if (!_xos || _xos->tick() == _tick)
+    return;
+  _lastTickSyscalls = _tickSyscalls;
+  _tickSyscalls = 0;
+  _tick = _xos->tick();
+  XOSDEBUG("procfs/sysfs syscalls last tick: %lu (%lu total)\n",
+           _lastTickSyscalls, syscalls());
+}
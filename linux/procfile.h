@@ -0,0 +1,71 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _PROCFILE_H_
+#define _PROCFILE_H_
+
+#include <string>
+#include <vector>
+
+class XOSView;
+
+
+//  A /proc or /sys file that is opened once and then re-read in place
+//  with pread() on every sample, until a read returns nothing.  The
+//  buffer keeps the size of the largest read so far, so a steady-state
+//  read makes no allocation.  The file is only reopened if a read
+//  fails (e.g. a hot-plugged device went away and came back).
+class ProcFile {
+public:
+  ProcFile( const char *filename = NULL );
+  ~ProcFile( void );
+
+  void filename( const char *filename );
+  const char *filename( void ) const { return _filename.c_str(); }
+
+  //  Returns the NUL terminated contents of the file, or NULL if it
+  //  can not be read.  The buffer belongs to this object and stays
+  //  valid until the next read(); callers may modify it in place
+  //  (strtok() and the like).
+  char *read( void );
+  size_t length( void ) const { return _len; }
+  //  The contents from the last read().
+  const char *buffer( void ) const { return &_buf[0]; }
+  //  The remainder of the line in the last read() starting with key
+  //  (followed by blanks), or NULL.  For "key value" files like
+  //  /proc/stat, /proc/vmstat or /proc/meminfo.
+  const char *find( const char *key ) const;
+
+  //  Open/pread/close calls made by all ProcFiles.  The count for the
+  //  last complete tick is kept once tickSource() is set, for each
+  //  thread against its own tick (see XOSView::tick()), and is the
+  //  calling thread's.
+  static unsigned long syscalls( void )
+    { return __atomic_load_n(&_syscalls, __ATOMIC_RELAXED); }
+  static unsigned long syscallsLastTick( void ) { return _lastTickSyscalls; }
+  static void tickSource( const XOSView *xos ) { _xos = xos; }
+
+private:
+  ProcFile( const ProcFile & );
+  ProcFile &operator=( const ProcFile & );
+
+  bool reopen( void );
+  void close( void );
+  bool pread( void );
+  static void count( void );
+  static void counted( void );
+
+  std::string _filename;
+  std::vector<char> _buf;
+  size_t _len;
+  int _fd;
+
+  static unsigned long _syscalls;
+  static __thread unsigned long _tickSyscalls, _lastTickSyscalls, _tick;
+  static const XOSView *_xos;
+};
+
+#endif
@@ -0,0 +1,120 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#include "procinterrupts.h"
+#include "decparse.h"
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+
+static const char INTFILE[] = "/proc/interrupts";
+
+
+ProcInterrupts &ProcInterrupts::instance( void ){
+  static ProcInterrupts interrupts;
+  return interrupts;
+}
+
+ProcInterrupts::ProcInterrupts( void )
+  : _file(INTFILE), _ncols(0), _tick(0), _loaded(false) {
+}
+
+ProcInterrupts::ProcInterrupts( const char *filename )
+  : _file(filename), _ncols(0), _tick(0), _loaded(false) {
+}
+
+void ProcInterrupts::update( unsigned long tick ){
+  if (_loaded && tick == _tick)
+    return;
+  char *buf = _file.read();
+  if (!buf) {
+    std::cerr << "Can not open file : " << _file.filename() << std::endl;
+    exit(1);
+  }
+  parse(parseHeader(buf));
+  _tick = tick;
+  _loaded = true;
+}
+
+unsigned long long ProcInterrupts::sum( int row, int ncols ) const {
+  const unsigned long long *c = counts(row);
+  unsigned long long rval = 0;
+
+  if (ncols > _ncols)
+    ncols = _ncols;
+  for (int i = 0 ; i < ncols ; i++)
+    rval += c[i];
+  return rval;
+}
+
+unsigned long long ProcInterrupts::total( void ) const {
+  unsigned long long rval = 0;
+
+  for (unsigned int i = 0 ; i < _counts.size() ; i++)
+    rval += _counts[i];
+  return rval;
+}
+
+//  The first line names the cpu columns ("CPU0 CPU1 ...").  The number
+//  of columns only changes with cpu hotplug, so it is only counted again
+//  when the line differs from last time.  Returns the start of the
+//  next line.
+char *ProcInterrupts::parseHeader( char *buf ){
+  char *end = strchr(buf, '\n');
+  size_t len = end ? end - buf : strlen(buf);
+
+  if (_header.size() != len || _header.compare(0, len, buf, len)) {
+    _header.assign(buf, len);
+    _ncols = 0;
+    for (const char *cur = _header.c_str() ;
+         (cur = strstr(cur, "CPU")) ; cur += 3)
+      _ncols++;
+    _irqs.clear();
+    _counts.clear();
+  }
+
+  return end ? end + 1 : buf + len;
+}
+
+void ProcInterrupts::parse( const char *buf ){
+  const char *cur = buf;
+  unsigned long long irq;
+  unsigned int row = 0;
+
+  if (!_ncols) {
+    _irqs.clear();
+    return;
+  }
+
+  while (*cur) {
+    //  Stops at the first non-numeric (NMI, LOC, ...) line.
+    if ( !(cur = decparse(cur, &irq)) || *cur != ':' )
+      break;
+    cur++;
+
+    if (row >= _irqs.size()) {
+      _irqs.resize(row + 1);
+      _counts.resize((row + 1) * _ncols);
+    }
+    _irqs[row] = irq;
+
+    //  Some lines (e.g. chained irqs on some arches) have fewer columns.
+    unsigned long long *c = &_counts[row * _ncols];
+    int n = decparse(cur, c, _ncols, &cur);
+    memset(c + n, 0, (_ncols - n) * sizeof(c[0]));
+    row++;
+
+    if ( !(cur = strchr(cur, '\n')) )
+      break;
+    cur++;
+  }
+
+  //  Irqs may have been freed since the last read.
+  if (row < _irqs.size()) {
+    _irqs.resize(row);
+    _counts.resize(row * _ncols);
+  }
+}
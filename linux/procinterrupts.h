@@ -0,0 +1,59 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _PROCINTERRUPTS_H_
+#define _PROCINTERRUPTS_H_
+
+#include "procfile.h"
+#include <string>
+#include <vector>
+
+
+//  One parsed copy of /proc/interrupts shared by the IntMeters (one per
+//  cpu with intSeparate) and the IrqRateMeter.  The file is read at most
+//  once per sampling tick (see XOSView::tick()) into a dense irq x cpu
+//  matrix of counters.  Only the numbered irq lines are kept, the named
+//  ones (NMI, LOC, ...) at the end of the file are skipped.
+class ProcInterrupts {
+public:
+  static ProcInterrupts &instance( void );
+  //  A copy of a file of its own, rather than the shared /proc one.
+  explicit ProcInterrupts( const char *filename );
+
+  //  Re-read the file unless it was already read during this tick.
+  void update( unsigned long tick );
+
+  //  Number of cpu columns in the file.
+  int cpus( void ) const { return _ncols; }
+  //  Number of numbered irq lines, and the irq number of each.
+  int rows( void ) const { return _irqs.size(); }
+  int irq( int row ) const { return _irqs[row]; }
+  //  Counters of one irq line, one per cpu column.
+  const unsigned long long *counts( int row ) const
+    { return &_counts[row * _ncols]; }
+  //  Sum of the first ncols columns of an irq line.
+  unsigned long long sum( int row, int ncols ) const;
+  //  Sum of all counters in the matrix.
+  unsigned long long total( void ) const;
+
+private:
+  ProcInterrupts( void );
+  ProcInterrupts( const ProcInterrupts & );
+  ProcInterrupts &operator=( const ProcInterrupts & );
+
+  char *parseHeader( char *buf );
+  void parse( const char *buf );
+
+  ProcFile _file;
+  std::string _header;  // column layout is only redone when this changes
+  int _ncols;
+  std::vector<int> _irqs;
+  std::vector<unsigned long long> _counts;  // rows() x cpus()
+  unsigned long _tick;
+  bool _loaded;
+};
+
+#endif
@@ -0,0 +1,90 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#include "procstat.h"
+#include "decparse.h"
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+
+static const char STATFILENAME[] = "/proc/stat";
+
+
+ProcStat &ProcStat::instance(void){
+  static ProcStat stat;
+  return stat;
+}
+
+ProcStat::ProcStat(void)
+  : _file(STATFILENAME), _tick(0), _loaded(false) {
+}
+
+void ProcStat::update(unsigned long tick){
+  if (_loaded && tick == _tick)
+    return;
+  char *buf = _file.read();
+  if (!buf) {
+    std::cerr << "Can not open file : " << STATFILENAME << std::endl;
+    exit(1);
+  }
+  parse(buf);
+  _tick = tick;
+  _loaded = true;
+}
+
+int ProcStat::cpuCount(void){
+  if (!_loaded)
+    update(0);
+  return _cpunums.empty() ? 0 : _cpunums.size() - 1;
+}
+
+int ProcStat::cpuRow(int cpunum) const {
+  for (unsigned int i = 0 ; i < _cpunums.size() ; i++)
+    if (_cpunums[i] == cpunum)
+      return i;
+  return -1;
+}
+
+void ProcStat::parse(const char *buf){
+  const char *cur = buf;
+  unsigned long long val;
+  unsigned int row = 0;
+
+  while (*cur) {
+    if (!strncmp(cur, "cpu", 3)) {
+      int cpunum = -1;
+      cur += 3;
+      if (*cur != ' ') {
+        const char *end = decparse(cur, &val);
+        if (end) {
+          cpunum = val;
+          cur = end;
+        }
+      }
+      if (row >= _cpunums.size()) {
+        _cpunums.resize(row + 1);
+        _cputimes.resize((row + 1) * NUMCOLS);
+      }
+      _cpunums[row] = cpunum;
+
+      //  Older kernels have fewer columns, those are left at zero.
+      unsigned long long *times = &_cputimes[row * NUMCOLS];
+      int n = decparse(cur, times, NUMCOLS, &cur);
+      memset(times + n, 0, (NUMCOLS - n) * sizeof(times[0]));
+      row++;
+    }
+
+    if ( !(cur = strchr(cur, '\n')) )
+      break;
+    cur++;
+  }
+
+  //  CPUs may have gone offline since the last read.
+  if (row < _cpunums.size()) {
+    _cpunums.resize(row);
+    _cputimes.resize(row * NUMCOLS);
+  }
+}
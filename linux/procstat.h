@@ -0,0 +1,57 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _PROCSTAT_H_
+#define _PROCSTAT_H_
+
+#include "procfile.h"
+#include <vector>
+
+
+//  One parsed copy of /proc/stat shared by every meter that needs it.
+//  The file is read at most once per sampling tick (see XOSView::tick()),
+//  no matter how many CPU meters are asking for their own line.
+class ProcStat {
+public:
+  enum { NUMCOLS = 10 };  // user nice system idle iowait irq softirq
+                          // steal guest guest_nice
+
+  static ProcStat &instance(void);
+
+  //  Re-read the file unless it was already read during this tick.
+  void update(unsigned long tick);
+
+  //  Number of "cpuN" lines, not counting the aggregate "cpu" line.
+  int cpuCount(void);
+
+  //  Row of the "cpuN" line, or -1 if there is no such line.  The
+  //  aggregate "cpu" line is cpu number -1, and always row 0.
+  int cpuRow(int cpunum) const;
+  //  The cpu number (-1 for the aggregate) a row belongs to.
+  int cpuNum(int row) const { return _cpunums[row]; }
+  const unsigned long long *cputime(int row) const
+    { return &_cputimes[row * NUMCOLS]; }
+  int rows(void) const { return _cpunums.size(); }
+
+  //  The remainder of the line starting with key, or NULL.  For the
+  //  few meters that look at other lines of the file.
+  const char *find(const char *key) const { return _file.find(key); }
+
+private:
+  ProcStat(void);
+  ProcStat(const ProcStat &);
+  ProcStat &operator=(const ProcStat &);
+
+  void parse(const char *buf);
+
+  ProcFile _file;
+  std::vector<unsigned long long> _cputimes;  // rows() x NUMCOLS
+  std::vector<int> _cpunums;
+  unsigned long _tick;
+  bool _loaded;
+};
+
+#endif
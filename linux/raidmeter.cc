@@ -9,7 +9,6 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <fstream>
 #include <sstream>
 #include <iostream>
 
@@ -17,7 +16,7 @@ static const char *RAIDFILE    = "/proc/mdstat";
 
 
 RAIDMeter::RAIDMeter( XOSView *parent, int raiddev)
-  : BitFieldMeter( parent, 1, 2, "RAID") {
+  : BitFieldMeter( parent, 1, 2, "RAID"), _raidfile(RAIDFILE) {
   _raiddev = raiddev;
   getRAIDstate();
   if(disknum<1)
@@ -118,17 +117,18 @@ int RAIDMeter::raidparse(char *cp){
 }
 
 void RAIDMeter::getRAIDstate( void ){
-  std::ifstream raidfile( RAIDFILE );
-  char l[256];
+  char *l = _raidfile.read(), *next;
 
-  if ( !raidfile ){
+  if ( !l ){
     std::cerr <<"Can not open file : " <<RAIDFILE << std::endl;
     exit( 1 );
   }
 
+  // raidparse() takes one NUL terminated line at a time
   do{
-    raidfile.getline(l,256);
-  }while((raidparse(l)==0) && (!raidfile.eof()));
+    if ( (next = strchr(l, '\n')) )
+      *next++ = '\0';
+  }while((raidparse(l)==0) && (l = next));
 
 //  printf("md0 %s %s %s resync: %s\n",type,state,working_map,resync_state);
 }
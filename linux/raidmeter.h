@@ -9,6 +9,7 @@
 
 #include "bitfieldmeter.h"
 #include "xosview.h"
+#include "procfile.h"
 
 #define MAX_MD 8
 
@@ -33,6 +34,7 @@ protected:
        working_map[20],
        resync_state[20];
   int  disknum;
+  ProcFile _raidfile;
 
   unsigned long doneColor_, todoColor_, completeColor_;
 
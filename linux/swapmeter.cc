@@ -23,14 +23,13 @@ void SwapMeter::checkResources( void ){
   setfieldcolor( 0, parent_->getResource( "swapUsedColor" ) );
   setfieldcolor( 1, parent_->getResource( "swapFreeColor" ) );
   priority_ = atoi (parent_->getResource( "swapPriority" ) );
-  dodecay_ = parent_->isResourceTrue( "swapDecay" );
+  useDecay( "swapDecay" );
   useGraph_ = parent_->isResourceTrue( "swapGraph" );
   SetUsedFormat (parent_->getResource("swapUsedFormat"));
 }
 
-void SwapMeter::checkevent( void ){
+void SwapMeter::sample( void ){
   getswapinfo();
-  drawfields();
 }
 
 void SwapMeter::getswapinfo( void ){
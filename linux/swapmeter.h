@@ -17,7 +17,8 @@ public:
   ~SwapMeter( void );
 
   const char *name( void ) const { return "SwapMeter"; }
-  void checkevent( void );
+  bool splitSample( void ) const { return true; }
+  void sample( void );
 
   void checkResources( void );
 protected:
@@ -8,13 +8,14 @@
 #include "wirelessmeter.h"
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <glob.h>
-#include <fstream>
 #include <iostream>
 
 
 WirelessMeter::WirelessMeter( XOSView *parent, int ID, const char *wlID)
-  : FieldMeterGraph ( parent, 2, wlID, "LINK/LEVEL", 1, 1, 0 ), _number(ID) {
+  : FieldMeterGraph ( parent, 2, wlID, "LINK/LEVEL", 1, 1, 0 ), _number(ID),
+    _wlfile(WLFILENAME) {
   _lastquality = -1;
   _lastlink = true;
   total_ = 0;
@@ -32,7 +33,7 @@ void WirelessMeter::checkResources( void ){
   setfieldcolor( 1, parent_->getResource( "wirelessUsedColor" ) );
 
   priority_ = atoi(parent_->getResource( "wirelessPriority" ) );
-  dodecay_ = parent_->isResourceTrue( "wirelessDecay" );
+  useDecay( "wirelessDecay" );
   SetUsedFormat(parent_->getResource( "wirelessUsedFormat" ) );
 }
 
@@ -43,36 +44,39 @@ void WirelessMeter::checkevent( void ){
 }
 
 void WirelessMeter::getpwrinfo( void ){
-  std::ifstream loadinfo( WLFILENAME );
-  if ( !loadinfo ){
+  const char *line = _wlfile.read();
+  if ( !line ){
     std::cerr << "Can not open file : " << WLFILENAME << std::endl;
     parent_->done(1);
     return;
   }
 
-  char buff[16];
+  char name[64];
   int linkq = 0, quality = 0;
   bool link = false;
 
   // skip the two header rows
-  loadinfo.ignore(1024, '\n');
-  loadinfo.ignore(1024, '\n');
+  for (int i = 0; i < 2 && line; i++)
+    if ( (line = strchr(line, '\n')) )
+      line++;
 
   if ( _devname.empty() ) {  // find devname on first run
-    for (int i = 0; i < _number; i++)
-      loadinfo.ignore(1024, '\n');
-    if ( loadinfo.good() )
-      loadinfo >> _devname >> buff >> linkq;
+    for (int i = 0; i < _number && line; i++)
+      if ( (line = strchr(line, '\n')) )
+        line++;
+    if ( line && sscanf(line, "%63s %*s %d", name, &linkq) >= 1 )
+      _devname = name;
   }
   else {
-    while ( !loadinfo.eof() ) {
-      loadinfo >> buff;
-      if ( _devname == buff ) {
-        loadinfo >> buff >> linkq;
+    while ( line && *line ) {
+      if ( sscanf(line, "%63s %*s %d", name, &linkq) >= 1 &&
+           _devname == name ) {
         link = true;
         break;
       }
-      loadinfo.ignore(1024, '\n');
+      linkq = 0;
+      if ( (line = strchr(line, '\n')) )
+        line++;
     }
   }
 
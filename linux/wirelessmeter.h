@@ -10,6 +10,7 @@
 
 #include "fieldmetergraph.h"
 #include "xosview.h"
+#include "procfile.h"
 #include <string>
 
 static const char WLFILENAME[] = "/proc/net/wireless";
@@ -35,6 +36,7 @@ private:
   int _lastquality, _number;
   std::string _devname;
   bool _lastlink;
+  ProcFile _wlfile;
 };
 
 
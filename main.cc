@@ -5,19 +5,31 @@
 //
 
 #include "xosview.h"
+#include <stdlib.h>
 #include <string.h>
+#include <iostream>
 
 int main( int argc, char *argv[] ) {
   /*  Icky.  Need to check for -name option here.  */
   char** argp = argv;
   const char* instanceName = "xosview";	// Default value.
+  const char* recordFile = NULL;	//  Record instead of displaying.
   while (argp && *argp)
   {
     if (!strncmp(*argp, "-name", 6))
       instanceName = argp[1];
+    if (!strcmp(*argp, "--record") || !strcmp(*argp, "-record"))
+    {
+      if (!argp[1])
+      {
+        std::cerr << *argp << " needs a file to record to." << std::endl;
+        exit(1);
+      }
+      recordFile = argp[1];
+    }
     argp++;
   }  //  instanceName will end up pointing to the last such -name option.
-  XOSView xosview( instanceName, argc, argv );
+  XOSView xosview( instanceName, argc, argv, recordFile );
 
   xosview.run();
 
@@ -19,6 +19,10 @@ Meter::Meter( XOSView *parent, const char *title, const char *legend,
   dousedlegends_ = dousedlegends;
   priority_ = 1;
   counter_ = 0;
+  passes_ = 0;
+  periods_ = 1;
+  samples_ = 0;
+  threaded_ = false;
   resize( parent->xoff(), parent->newypos(), parent->width() - 10, 10 );
 
 }
@@ -54,6 +58,7 @@ void Meter::legend( const char *legend ){
   legend_ = new char[len + 1];
   strncpy( legend_, legend, len );
   legend_[len] = '\0'; // strncpy() will not null terminate if s2 > len
+  legendFields_.set( legend_ );
 }
 
 void Meter::resize( int x, int y, int width, int height ){
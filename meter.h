@@ -8,6 +8,7 @@
 #define _METER_H_
 
 #include "xosview.h"
+#include "legend.h"
 #include <iostream>
 
 
@@ -21,22 +22,63 @@ public:
   void resize( int x, int y, int width, int height );
   virtual void checkevent( void ) = 0;
   virtual void draw( void ) = 0;
+
+  //  checkevent() in two halves, for the meters that can do it that way
+  //  (splitSample() is true).  sample() reads the system's counters and
+  //  must not touch the display, publish() hands the values over and
+  //  render() draws the last ones handed over.  With the samplerThread
+  //  resource set XOSView runs sample() and publish() of these meters
+  //  in a thread of its own, so that a slow read does not hold up the
+  //  drawing and the X events.
+  virtual bool splitSample( void ) const { return false; }
+  virtual void sample( void ) {}
+  virtual void publish( void ) {}
+  virtual void render( void ) {}
+  //  Set before the sampler thread starts, for the meters it samples.
+  void threaded( bool val ) { threaded_ = val; }
+  bool threaded( void ) const { return threaded_; }
+  //  The values the last sample() took (see --record).  Only the meters
+  //  with fields have any.
+  virtual int numValues( void ) const { return 0; }
+  virtual const double *values( void ) const { return NULL; }
   void title( const char *title );
   const char *title( void ) { return title_; }
   void legend( const char *legend );
   const char *legend( void ) { return legend_; }
+  const Legend &legendFields( void ) const { return legendFields_; }
+  int priority( void ) const { return priority_; }
   void docaptions( int val ) { docaptions_ = val; }
   void dolegends( int val ) { dolegends_ = val; }
   void dousedlegends( int val ) { dousedlegends_ = val; }
-  int requestevent( void ){
+  //  Whether to sample on this pass.  slowdown stretches the period
+  //  (see obscuredSampleDivisor).
+  int requestevent( int slowdown = 1 ){
     if (priority_ == 0) {
       std::cerr << "Warning:  meter " << name() << " had an invalid priority "
                 << "of 0. Resetting to 1..." << std::endl;
       priority_ = 1;
     }
-    int rval = counter_ % priority_;
-    counter_ = (counter_ + 1) % priority_;
-    return !rval;
+    int period = priority_ * slowdown;
+    int rval = counter_ % period;
+    counter_ = (counter_ + 1) % period;
+    passes_++;
+    if (rval)
+      return 0;
+    if ( !(periods_ = passes_ / priority_) )
+      periods_ = 1;
+    passes_ = 0;
+    samples_++;
+    return 1;
+  }
+
+  //  How many graph columns a frame (see framesPerSec) showing samples
+  //  that covered this many sample periods moves the graph along.  A
+  //  column is one frame, or one sample period if that is longer.
+  int columns( int periods ) const {
+    int frame = parent_->frameDivisor();
+    int step = ( priority_ > frame ? priority_ : frame );
+    int rval = ( periods * priority_ + step / 2 ) / step;
+    return ( rval > 0 ? rval : 1 );
   }
 
   int getX() const { return x_; }
@@ -52,7 +94,11 @@ protected:
   XOSView *parent_;
   int x_, y_, width_, height_, docaptions_, dolegends_, dousedlegends_;
   int priority_, counter_;
+  int passes_, periods_;  // periods_: how many sample periods this one covers
+  unsigned long samples_;  // times requestevent() said to sample
+  bool threaded_;
   char *title_, *legend_;
+  Legend legendFields_;  // legend_ split into its fields
   unsigned long textcolor_;
   double samplesPerSecond() { return 1.0*MAX_SAMPLES_PER_SECOND/priority_; }
   double secondsPerSample() { return 1.0/samplesPerSecond(); }
@@ -0,0 +1,115 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#include "pacer.h"
+#include "timer.h"
+#include <unistd.h>
+#include <errno.h>
+#include <stdint.h>
+#include <time.h>
+#ifdef __linux__
+#include <sys/timerfd.h>
+#endif
+
+
+Pacer::Pacer( void ) : period_(0), deadline_(0), missed_(0), fd_(-1) {
+}
+
+Pacer::~Pacer( void ){
+  if (fd_ >= 0)
+    close(fd_);
+}
+
+void Pacer::period( double secs ){
+  period_ = secs * 1e9;
+  deadline_ = 0;
+  if (fd_ >= 0)
+    arm();
+}
+
+//  Set the next deadline one period on from the last one (the first is
+//  now), skipping the ones that have already passed.
+void Pacer::advance( unsigned long long now ){
+  if (!deadline_ || !period_)
+    deadline_ = now;
+  deadline_ += period_;
+  if (period_ && now >= deadline_) {
+    unsigned long long late = (now - deadline_) / period_ + 1;
+    missed_ += late;
+    deadline_ += late * period_;
+  }
+}
+
+void Pacer::wait( void ){
+  advance(Timer::nsecs());
+
+#if defined(CLOCK_MONOTONIC) && defined(TIMER_ABSTIME)
+  struct timespec ts;
+  ts.tv_sec = deadline_ / 1000000000ULL;
+  ts.tv_nsec = deadline_ % 1000000000ULL;
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    ;
+#else
+  for (unsigned long long now ; (now = Timer::nsecs()) < deadline_ ; ) {
+    struct timespec ts;
+    ts.tv_sec = (deadline_ - now) / 1000000000ULL;
+    ts.tv_nsec = (deadline_ - now) % 1000000000ULL;
+    nanosleep(&ts, NULL);
+  }
+#endif
+}
+
+int Pacer::fd( void ){
+#if defined(__linux__) && defined(TFD_NONBLOCK)
+  if (fd_ < 0 && (fd_ = timerfd_create(CLOCK_MONOTONIC,
+                                       TFD_NONBLOCK | TFD_CLOEXEC)) >= 0)
+    arm();
+#endif
+  return fd_;
+}
+
+//  The timerfd fires at now and every period after that.
+void Pacer::arm( void ){
+#if defined(__linux__) && defined(TFD_NONBLOCK)
+  struct itimerspec its;
+  struct timespec now;
+
+  Timer::now(&now);
+  its.it_value = now;
+  its.it_interval.tv_sec = period_ / 1000000000ULL;
+  its.it_interval.tv_nsec = period_ % 1000000000ULL;
+  if (timerfd_settime(fd_, TFD_TIMER_ABSTIME, &its, NULL) < 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+#endif
+}
+
+int Pacer::timeout( void ) const {
+  if (fd_ >= 0)
+    return -1;
+
+  unsigned long long now = Timer::nsecs();
+  if (now >= deadline_)
+    return 0;
+  return (deadline_ - now + 999999) / 1000000;
+}
+
+bool Pacer::due( void ){
+  if (fd_ >= 0) {
+    uint64_t expired;
+    if (read(fd_, &expired, sizeof(expired)) != sizeof(expired))
+      return false;
+    missed_ += expired - 1;
+    return true;
+  }
+
+  unsigned long long now = Timer::nsecs();
+  if (now < deadline_)
+    return false;
+  advance(now);
+  return true;
+}
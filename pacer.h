@@ -0,0 +1,50 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _PACER_H_
+#define _PACER_H_
+
+//
+//  Paces a loop at a fixed period on Timer's (monotonic) clock.  The
+//  deadlines are absolute times, so the work done in the loop does not
+//  add to the period.  A pass that takes longer than the period skips
+//  the deadlines it missed (counted in missed()) rather than running a
+//  burst of passes to catch up.
+//
+//  A loop either sleeps in wait(), or waits on other things as well
+//  (see XOSView::run()) and asks due() whether the deadline has come.
+//  fd() is a descriptor that becomes readable at the deadline (a
+//  timerfd, where there is one) and timeout() the msecs left until it,
+//  for poll().
+//
+
+class Pacer {
+public:
+  Pacer( void );
+  ~Pacer( void );
+
+  void period( double secs );
+  unsigned long missed( void ) const { return missed_; }
+
+  void wait( void );
+
+  int fd( void );
+  int timeout( void ) const;
+  bool due( void );
+
+private:
+  unsigned long long period_, deadline_;  // nsecs on Timer's clock
+  unsigned long missed_;
+  int fd_;
+
+  void arm( void );
+  void advance( unsigned long long now );
+
+  Pacer( const Pacer & );
+  Pacer &operator=( const Pacer & );
+};
+
+#endif
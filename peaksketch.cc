@@ -0,0 +1,68 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#include "peaksketch.h"
+#include <string.h>
+
+
+PeakSketch::PeakSketch( double secs, int maxsamples )
+  : size_(maxsamples > 0 ? maxsamples : 1), head_(0), n_(0),
+    nsecs_((unsigned long long)(secs * 1e9)) {
+  ring_ = new Entry[size_];
+  memset(values_, 0, sizeof(values_));
+  memset(peaks_, 0, sizeof(peaks_));
+}
+
+PeakSketch::~PeakSketch( void ){
+  delete[] ring_;
+}
+
+int PeakSketch::bucket( double fraction ){
+  if (!(fraction > 0))
+    return 0;
+  if (fraction >= 1)
+    return BUCKETS - 1;
+  return (int)(fraction * (BUCKETS - 1) + 0.5);
+}
+
+void PeakSketch::drop( void ){
+  values_[ring_[head_].value]--;
+  peaks_[ring_[head_].peak]--;
+  if (++head_ >= size_)
+    head_ = 0;
+  n_--;
+}
+
+void PeakSketch::add( double value, double peak, unsigned long long when ){
+  while (n_ && (n_ == size_ || when - ring_[head_].when > nsecs_))
+    drop();
+
+  Entry &e = ring_[(head_ + n_) % size_];
+  e.when = when;
+  e.value = bucket(value);
+  e.peak = bucket(peak > value ? peak : value);
+  values_[e.value]++;
+  peaks_[e.peak]++;
+  n_++;
+}
+
+double PeakSketch::peak( void ) const {
+  for (int i = BUCKETS - 1 ; i > 0 ; i--)
+    if (peaks_[i])
+      return i / (double)(BUCKETS - 1);
+  return 0;
+}
+
+//  The value that a fraction q of the samples are no more than.
+double PeakSketch::quantile( double q ) const {
+  unsigned int above = (unsigned int)((1 - q) * n_);
+  unsigned int count = 0;
+
+  for (int i = BUCKETS - 1 ; i > 0 ; i--)
+    if ((count += values_[i]) > above)
+      return i / (double)(BUCKETS - 1);
+  return 0;
+}
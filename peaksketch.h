@@ -0,0 +1,54 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _PEAKSKETCH_H_
+#define _PEAKSKETCH_H_
+
+//
+//  The recent peak and percentiles of a meter's used value, as a fraction
+//  of the meter (see peakOverlay).  The samples of the last window()
+//  seconds are counted in two fixed histograms of BUCKETS buckets, one of
+//  the values and one of the peaks (the largest sample behind each value,
+//  which for the averaging meters is more than the value), and kept in a
+//  ring, allocated once, so that they can be taken out of the histograms
+//  again as they leave the window.  add() is O(1); peak() and quantile()
+//  walk the buckets, which is only done when a meter is drawn.
+//
+
+class PeakSketch {
+public:
+  enum { BUCKETS = 200 };
+
+  //  Keeps the samples of the last secs seconds, of which there are at
+  //  most maxsamples.
+  PeakSketch( double secs, int maxsamples );
+  ~PeakSketch( void );
+
+  //  Values are fractions of the meter, when is nsecs on Timer's clock.
+  void add( double value, double peak, unsigned long long when );
+
+  bool empty( void ) const { return !n_; }
+  double peak( void ) const;
+  double quantile( double q ) const;
+
+private:
+  struct Entry {
+    unsigned long long when;
+    unsigned char value, peak;
+  };
+  Entry *ring_;
+  int size_, head_, n_;       //  head_ is the oldest entry
+  unsigned long long nsecs_;
+  unsigned int values_[BUCKETS], peaks_[BUCKETS];
+
+  static int bucket( double fraction );
+  void drop( void );
+
+  PeakSketch( const PeakSketch & );
+  PeakSketch &operator=( const PeakSketch & );
+};
+
+#endif
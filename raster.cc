@@ -0,0 +1,180 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#include "raster.h"
+#include "xwin.h"
+#include "xosview.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+
+Raster::Raster( XWin *parent )
+  : parent_(parent), image_(NULL), shm_(false), fast_(false), serial_(0) {
+}
+
+Raster::~Raster( void ){
+  destroy();
+}
+
+void Raster::destroy( void ){
+  if (!image_)
+    return;
+  if (shm_) {
+    sync();
+    XShmDetach(parent_->display(), &shminfo_);
+    XDestroyImage(image_);
+    shmdt(shminfo_.shmaddr);
+  }
+  else
+    XDestroyImage(image_);  //  frees the data as well
+  image_ = NULL;
+  shm_ = false;
+}
+
+static bool shmFailed;
+
+static int shmError( Display *, XErrorEvent * ){
+  shmFailed = true;
+  return 0;
+}
+
+//  The server may have the extension and still not be able to attach
+//  (it is on another host, say), which only shows as an error later on.
+bool Raster::createShm( int width, int height ){
+  Display *display = parent_->display();
+  int screen = DefaultScreen(display);
+  static int usable = -1;
+
+  if (usable < 0)
+    usable = XShmQueryExtension(display);
+  if (!usable)
+    return false;
+
+  image_ = XShmCreateImage(display, DefaultVisual(display, screen),
+                           DefaultDepth(display, screen), ZPixmap, NULL,
+                           &shminfo_, width, height);
+  if (!image_)
+    return false;
+
+  shminfo_.shmid = shmget(IPC_PRIVATE, image_->bytes_per_line * height,
+                          IPC_CREAT | 0600);
+  if (shminfo_.shmid < 0) {
+    XDestroyImage(image_);
+    image_ = NULL;
+    return false;
+  }
+  shminfo_.shmaddr = image_->data = (char *)shmat(shminfo_.shmid, NULL, 0);
+  shminfo_.readOnly = True;
+
+  shmFailed = false;
+  XSync(display, False);
+  int (*handler)(Display *, XErrorEvent *) = XSetErrorHandler(shmError);
+  if (shminfo_.shmaddr != (char *)-1)
+    XShmAttach(display, &shminfo_);
+  else
+    shmFailed = true;
+  XSync(display, False);
+  XSetErrorHandler(handler);
+
+  //  Freed once both sides have let go of it.
+  shmctl(shminfo_.shmid, IPC_RMID, NULL);
+
+  if (shmFailed) {
+    XOSDEBUG("MIT-SHM not usable, using XPutImage().\n");
+    usable = 0;
+    if (shminfo_.shmaddr != (char *)-1)
+      shmdt(shminfo_.shmaddr);
+    image_->data = NULL;
+    XDestroyImage(image_);
+    image_ = NULL;
+    return false;
+  }
+
+  shm_ = true;
+  serial_ = 0;
+  return true;
+}
+
+bool Raster::size( int width, int height ){
+  if (image_ && image_->width == width && image_->height == height)
+    return true;
+  destroy();
+  if (width <= 0 || height <= 0)
+    return false;
+
+  if (!createShm(width, height)) {
+    Display *display = parent_->display();
+    int screen = DefaultScreen(display);
+
+    image_ = XCreateImage(display, DefaultVisual(display, screen),
+                          DefaultDepth(display, screen), ZPixmap, 0, NULL,
+                          width, height, 32, 0);
+    if (!image_)
+      return false;
+    if (!(image_->data = (char *)malloc(image_->bytes_per_line * height))) {
+      XDestroyImage(image_);
+      image_ = NULL;
+      return false;
+    }
+  }
+
+  const uint16_t one = 1;
+  int native = *(const char *)&one ? LSBFirst : MSBFirst;
+  fast_ = (image_->bits_per_pixel == 32 && image_->byte_order == native);
+  return true;
+}
+
+//  The server reads a shared image when it gets to the put() request,
+//  so the image must not change before then.
+void Raster::sync( void ){
+  if (shm_ && serial_ && LastKnownRequestProcessed(parent_->display()) < serial_)
+    XSync(parent_->display(), False);
+  serial_ = 0;
+}
+
+void Raster::fillRectangle( unsigned long pixel, int x, int y,
+                            int width, int height ){
+  if (!image_)
+    return;
+  sync();
+
+  //  Same size as drawFilledRectangle() would draw, clipped to the image.
+  int x2 = x + width + 1, y2 = y + height + 1;
+  if (x < 0)
+    x = 0;
+  if (y < 0)
+    y = 0;
+  if (x2 > image_->width)
+    x2 = image_->width;
+  if (y2 > image_->height)
+    y2 = image_->height;
+  if (x >= x2 || y >= y2)
+    return;
+
+  if (fast_) {
+    uint32_t p = pixel;
+    int n = x2 - x;
+    char *row = image_->data + y * image_->bytes_per_line;
+    for ( ; y < y2 ; y++, row += image_->bytes_per_line) {
+      uint32_t *dst = (uint32_t *)row + x;
+      for (int i = 0 ; i < n ; i++)
+        dst[i] = p;
+    }
+  }
+  else {
+    for ( ; y < y2 ; y++)
+      for (int i = x ; i < x2 ; i++)
+        XPutPixel(image_, i, y, pixel);
+  }
+}
+
+void Raster::put( int x, int y ){
+  if (!image_)
+    return;
+  serial_ = parent_->putImage(image_, shm_ ? &shminfo_ : NULL, x, y);
+}
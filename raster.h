@@ -0,0 +1,58 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _RASTER_H_
+#define _RASTER_H_
+
+//
+//  A client side image of part of the window, for meters that redraw a
+//  large area out of many small rectangles (see FieldMeterGraph).  The
+//  rectangles are filled in the image and the image is sent to the X
+//  server with one put(), through MIT-SHM shared memory when the server
+//  allows it and with XPutImage() when it does not, so the cost of a
+//  redraw does not depend on the number of rectangles.
+//
+
+#include <X11/Xlib.h>
+#include <X11/extensions/XShm.h>
+
+class XWin;
+
+
+class Raster {
+public:
+  Raster( XWin *parent );
+  ~Raster( void );
+
+  //  Makes the image width x height pixels, if it is not already.
+  //  Returns false if there is no image to draw into.
+  bool size( int width, int height );
+
+  //  The same rectangle as XWin::drawFilledRectangle() would fill, with
+  //  x and y relative to the image.
+  void fillRectangle( unsigned long pixel, int x, int y,
+                      int width, int height );
+
+  //  Copies the image to (x, y) in the window.
+  void put( int x, int y );
+
+private:
+  XWin *parent_;
+  XImage *image_;
+  XShmSegmentInfo shminfo_;
+  bool shm_;
+  bool fast_;             //  32 bit pixels in our byte order
+  unsigned long serial_;  //  Request that last read the shared image
+
+  void destroy( void );
+  bool createShm( int width, int height );
+  void sync( void );
+
+  Raster( const Raster & );
+  Raster &operator=( const Raster & );
+};
+
+#endif
@@ -0,0 +1,203 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#include "recorder.h"
+#include "meter.h"
+#include "timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <time.h>
+#include <iostream>
+
+
+Recorder::Recorder( const char *filename )
+  : filename_(filename), fd_(-1), used_(0), fields_(0),
+    lastframe_(0), lastsync_(0), syncnsecs_(0) {
+}
+
+Recorder::~Recorder( void ){
+  if ( fd_ >= 0 )
+    finish();
+}
+
+void Recorder::add( Meter *meter ){
+  meters_.push_back(meter);
+  fields_ += meter->numValues();
+}
+
+void Recorder::skip( const Meter *meter ){
+  skipped_.push_back(meter->name());
+}
+
+void Recorder::start( double samplesPerSec, double syncSecs ){
+  fd_ = open(filename_.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if ( fd_ < 0 ){
+    std::cerr << "Can not open " << filename_ << " : " << strerror(errno)
+              << std::endl;
+    exit(1);
+  }
+
+  buf_.resize(maxFrame() > BUFSIZE ? maxFrame() : BUFSIZE);
+  last_.assign(fields_, 0);
+  syncnsecs_ = (unsigned long long)((syncSecs > 0 ? syncSecs : 10) * 1e9);
+
+  char host[100];
+  gethostname(host, sizeof(host) - 1);
+  host[sizeof(host) - 1] = '\0';
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+  unsigned long long rate;
+  memcpy(&rate, &samplesPerSec, sizeof(rate));
+
+  room(4 + 8 + 2 + strlen(host) + 8 + 8 + 2);
+  put32(0xffffffff);
+  memcpy(&buf_[used_], "XOSVREC1", 8);
+  used_ += 8;
+  putString(host);
+  put64(ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+  put64(rate);
+  put16(meters_.size());
+
+  for ( unsigned int i = 0 ; i < meters_.size() ; i++ ){
+    Meter *m = meters_[i];
+    const Legend &legend = m->legendFields();
+    int n = m->numValues();
+
+    room(2 + strlen(m->name()) + 2 + strlen(m->title()) + 4 + 2);
+    putString(m->name());
+    putString(m->title());
+    put32(m->priority());
+    put16(n);
+    for ( int f = 0 ; f < n ; f++ ){
+      //  Some legends have fewer fields than the meter.
+      char name[16];
+      snprintf(name, sizeof(name), "field%d", f);
+      std::string field = f < legend.fields() ? legend.field(f)
+                                              : std::string(name);
+      room(2 + field.size());
+      putString(field);
+    }
+  }
+
+  room(2);
+  put16(skipped_.size());
+  for ( unsigned int i = 0 ; i < skipped_.size() ; i++ ){
+    room(2 + skipped_[i].size());
+    putString(skipped_[i]);
+  }
+
+  //  The header goes straight out, so that a reader can make sense of
+  //  the file from the start.
+  sync();
+  lastframe_ = lastsync_ = Timer::nsecs();
+}
+
+//  The usecs, the bitmap, and five bytes a field at most.
+unsigned int Recorder::maxFrame( void ) const {
+  return 4 + (fields_ + 7) / 8 + 5 * fields_;
+}
+
+void Recorder::frame( unsigned long long when ){
+  room(maxFrame());
+
+  unsigned long long usecs = (when - lastframe_) / 1000;
+  put32(usecs < 0xffffffffULL ? usecs : 0xfffffffeULL);
+  lastframe_ = when;
+
+  unsigned char *changed = &buf_[used_];
+  memset(changed, 0, (fields_ + 7) / 8);
+  unsigned char *p = changed + (fields_ + 7) / 8;
+  unsigned int field = 0;
+  for ( unsigned int i = 0 ; i < meters_.size() ; i++ ){
+    const double *values = meters_[i]->values();
+    int n = meters_[i]->numValues();
+
+    for ( int f = 0 ; f < n ; f++, field++ ){
+      float value = values[f];
+      unsigned int bits;
+      memcpy(&bits, &value, sizeof(bits));
+      unsigned int delta = bits ^ last_[field];
+      if ( !delta )
+        continue;
+      last_[field] = bits;
+      changed[field / 8] |= 1 << (field % 8);
+      for ( ; delta >= 0x80 ; delta >>= 7 )
+        *p++ = delta | 0x80;
+      *p++ = delta;
+    }
+  }
+  used_ = p - &buf_[0];
+
+  if ( when - lastsync_ >= syncnsecs_ ){
+    sync();
+    lastsync_ = when;
+  }
+}
+
+void Recorder::finish( void ){
+  sync();
+  close(fd_);
+  fd_ = -1;
+}
+
+void Recorder::put16( unsigned int val ){
+  buf_[used_++] = val;
+  buf_[used_++] = val >> 8;
+}
+
+void Recorder::put32( unsigned int val ){
+  put16(val);
+  put16(val >> 16);
+}
+
+void Recorder::put64( unsigned long long val ){
+  put32(val);
+  put32(val >> 32);
+}
+
+void Recorder::putString( const std::string &str ){
+  put16(str.size());
+  memcpy(&buf_[used_], str.data(), str.size());
+  used_ += str.size();
+}
+
+//  Makes room in the buffer for the next bytes (at most a frame).
+void Recorder::room( unsigned int bytes ){
+  if ( used_ + bytes > buf_.size() )
+    flush();
+}
+
+//  The buffer only holds whole frames, so the file ends between two of
+//  them unless the system goes down in the middle of a write.
+void Recorder::flush( void ){
+  unsigned int done = 0;
+
+  while ( done < used_ ){
+    ssize_t n = write(fd_, &buf_[done], used_ - done);
+    if ( n < 0 ){
+      if ( errno == EINTR )
+        continue;
+      std::cerr << "Can not write to " << filename_ << " : "
+                << strerror(errno) << std::endl;
+      exit(1);
+    }
+    done += n;
+  }
+  used_ = 0;
+}
+
+void Recorder::sync( void ){
+  flush();
+  if ( fsync(fd_) < 0 && errno != EINVAL ){
+    std::cerr << "Can not sync " << filename_ << " : " << strerror(errno)
+              << std::endl;
+    exit(1);
+  }
+}
@@ -0,0 +1,91 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _RECORDER_H_
+#define _RECORDER_H_
+
+//
+//  Records the values of the meters to a file (xosview --record FILE),
+//  without a display.  Each run appends a header describing the meters
+//  to the file, and then a frame for each pass that sampled any of them.
+//  Everything is little-endian, and a string is a u16 length and that
+//  many bytes:
+//
+//    header:  u32 0xffffffff, "XOSVREC1", string host,
+//             u64 wall clock at the start (nsecs since the epoch),
+//             f64 passes a second, u16 meters, and for each meter:
+//             string name, string title, u32 passes a sample (priority),
+//             u16 fields, and a string for each field (its legend),
+//             then u16 meters left out and the string name of each
+//    frame:   u32 usecs since the last frame (or the start), a bitmap
+//             of the fields that changed since the last frame (bit f % 8
+//             of byte f / 8, for the fields of all the meters in the
+//             order of the header), then for each field that changed
+//             the bits of its value as a 32 bit float, XORed with the
+//             bits of the last frame's (0 before the first frame), as a
+//             varint: 7 bits a byte, low ones first, with the top bit
+//             set on all bytes but the last
+//
+//  So a value that was not sampled again, or came out the same, takes a
+//  bit, and one that changed a little takes two or three bytes.  Values
+//  that change on every sample (the cpu fields, say) still take up to
+//  five.  A frame that starts with 0xffffffff is the header of the next
+//  run instead.
+//
+//  The frames go out through a large buffer, which is written out and
+//  synced to the disk every recordSync seconds, and when it is full.
+//
+
+#include <string>
+#include <vector>
+
+class Meter;
+
+
+class Recorder {
+public:
+  Recorder( const char *filename );
+  ~Recorder( void );
+
+  //  The meters go in before start() writes the header, and so do the
+  //  ones left out, so that a reader knows they were not forgotten.
+  void add( Meter *meter );
+  void skip( const Meter *meter );
+  int meters( void ) const { return meters_.size(); }
+
+  void start( double samplesPerSec, double syncSecs );
+  //  A frame of the meters' values as of when (nsecs on Timer's clock).
+  void frame( unsigned long long when );
+  //  Writes out and syncs what is left, and closes the file.
+  void finish( void );
+
+private:
+  enum { BUFSIZE = 1 << 20 };
+
+  std::string filename_;
+  int fd_;
+  std::vector<Meter *> meters_;
+  std::vector<std::string> skipped_;
+  std::vector<unsigned int> last_;   // the bits of the last frame's values
+  std::vector<unsigned char> buf_;
+  unsigned int used_;                // bytes of buf_ not yet written out
+  unsigned int fields_;
+  unsigned long long lastframe_, lastsync_, syncnsecs_;
+
+  void put16( unsigned int val );
+  void put32( unsigned int val );
+  void put64( unsigned long long val );
+  void putString( const std::string &str );
+  unsigned int maxFrame( void ) const;
+  void room( unsigned int bytes );
+  void flush( void );
+  void sync( void );
+
+  Recorder( const Recorder & );
+  Recorder &operator=( const Recorder & );
+};
+
+#endif
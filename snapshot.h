@@ -0,0 +1,112 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _SNAPSHOT_H_
+#define _SNAPSHOT_H_
+
+//
+//  Hands the values of a FieldMeter from the sampler thread to the X
+//  thread without either side ever waiting on the other.
+//
+//  There are two buffers.  publish() fills the one that is not current
+//  and then makes it current by bumping the sequence number, whose low
+//  bit names the current buffer.  read() copies the current buffer and
+//  starts over in the (rare) case that a publish() came in meanwhile,
+//  since the next one after that would write to the buffer being read.
+//  There is one writer and one reader per snapshot.
+//
+//  FieldMeter publishes running sums since the start, and the number of
+//  samples in them, so that the reader takes the difference from the
+//  ones it read last time.  No sample is then counted twice (or lost)
+//  however publish() and read() interleave.
+//
+
+#include <string.h>
+
+
+class Snapshot {
+public:
+  Snapshot( int numfields ) : numfields_(numfields), seq_(0) {
+    for ( int i = 0 ; i < 2 ; i++ ){
+      values_[i].fields = new double[numfields_];
+      memset(values_[i].fields, 0, numfields_ * sizeof(double));
+      values_[i].total = values_[i].used = 0;
+      values_[i].usedmin = values_[i].usedmax = 0;
+      values_[i].state = 0;
+      values_[i].periods = values_[i].samples = 0;
+    }
+  }
+  ~Snapshot( void ){
+    delete[] values_[0].fields;
+    delete[] values_[1].fields;
+  }
+
+  //  Sequence number of the last publish().
+  unsigned long seq( void ) const {
+    return __atomic_load_n(&seq_, __ATOMIC_ACQUIRE);
+  }
+
+  void publish( const double *fields, double total, double used,
+                double usedmin, double usedmax, int state,
+                unsigned long periods, unsigned long samples ){
+    unsigned long seq = seq_;
+    Values &v = values_[(seq + 1) & 1];
+
+    //  The previous publish() must be visible before this one starts
+    //  overwriting the buffer that was current before it.
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    memcpy(v.fields, fields, numfields_ * sizeof(double));
+    v.total = total;
+    v.used = used;
+    v.usedmin = usedmin;
+    v.usedmax = usedmax;
+    v.state = state;
+    v.periods = periods;
+    v.samples = samples;
+    __atomic_store_n(&seq_, seq + 1, __ATOMIC_RELEASE);
+  }
+
+  //  Copies the last published values, returns their sequence number.
+  unsigned long read( double *fields, double *total, double *used,
+                      double *usedmin, double *usedmax,
+                      int *state, unsigned long *periods,
+                      unsigned long *samples ) const {
+    unsigned long seq;
+
+    do {
+      seq = __atomic_load_n(&seq_, __ATOMIC_ACQUIRE);
+      const Values &v = values_[seq & 1];
+      memcpy(fields, v.fields, numfields_ * sizeof(double));
+      *total = v.total;
+      *used = v.used;
+      *usedmin = v.usedmin;
+      *usedmax = v.usedmax;
+      *state = v.state;
+      *periods = v.periods;
+      *samples = v.samples;
+      __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (__atomic_load_n(&seq_, __ATOMIC_RELAXED) != seq);
+
+    return seq;
+  }
+
+private:
+  struct Values {
+    double *fields;
+    double total, used, usedmin, usedmax;
+    int state;
+    unsigned long periods, samples;
+  };
+
+  int numfields_;
+  Values values_[2];
+  unsigned long seq_;
+
+  Snapshot( const Snapshot & );
+  Snapshot &operator=( const Snapshot & );
+};
+
+#endif
@@ -0,0 +1,111 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+//  AutoScale on synthetic samples: the window and its edge, the
+//  hysteresis, the floor, a window of 0, and snap() at and just above
+//  powers of two and of 1, 2 and 5 times ten.  Run by make check.
+
+#include "autoscale.h"
+#include "xosview.h"
+#include "check.h"
+
+//  Only configure() from the resources reads them, which the tests do
+//  not use.
+const char *XWin::getResourceOrUseDefault( const char *, const char *val ){
+  return val;
+}
+
+static const unsigned long long SEC = 1000000000ULL;
+
+static void window( void ){
+  AutoScale a;
+  a.configure(10, 0.25, AutoScale::NONE);
+
+  CHECK(a.update(100, 0, 1 * SEC) == 100);
+  CHECK(a.update(10, 0, 5 * SEC) == 100);
+  //  Right at the edge the 100 is still in the window, just past it not.
+  CHECK(a.update(10, 0, 11 * SEC) == 100);
+  CHECK(a.update(10, 0, 11 * SEC + 1) == 10);
+  CHECK(a.scale() == 10);
+}
+
+static void hysteresis( void ){
+  AutoScale a;
+  a.configure(0, 0.25, AutoScale::NONE);
+
+  CHECK(a.update(100, 0, 1 * SEC) == 100);
+  CHECK(a.update(80, 0, 2 * SEC) == 100);
+  //  Not until the largest value is under 100 * (1 - 0.25).
+  CHECK(a.update(75, 0, 3 * SEC) == 100);
+  CHECK(a.update(74, 0, 4 * SEC) == 74);
+  //  Up again at once.
+  CHECK(a.update(80, 0, 5 * SEC) == 80);
+}
+
+static void floor( void ){
+  AutoScale a;
+  a.configure(0, 0.25, AutoScale::NONE);
+
+  CHECK(a.update(10, 50, 1 * SEC) == 50);
+  CHECK(a.update(60, 50, 2 * SEC) == 60);
+  CHECK(a.update(1, 50, 3 * SEC) == 50);
+  CHECK(a.update(0, 50, 4 * SEC) == 50);
+}
+
+static void latest( void ){
+  AutoScale a;
+  a.configure(0, 0.25, AutoScale::NONE);
+
+  //  With a window of 0 only the latest sample counts.
+  CHECK(a.update(100, 0, 1 * SEC) == 100);
+  CHECK(a.update(10, 0, 1 * SEC + 1) == 10);
+  CHECK(a.update(1000, 0, 2 * SEC) == 1000);
+  CHECK(a.update(1, 0, 3 * SEC) == 1);
+
+  //  The scale is snapped, the hysteresis is against the value.
+  a.configure(0, 0.25, AutoScale::POW2);
+  CHECK(a.update(100, 0, 1 * SEC) == 128);
+  CHECK(a.update(97, 0, 2 * SEC) == 128);
+  CHECK(a.update(95, 0, 3 * SEC) == 128);
+  CHECK(a.update(64, 0, 4 * SEC) == 64);
+}
+
+static void snap( void ){
+  CHECK(AutoScale::snap(1, AutoScale::POW2) == 1);
+  CHECK(AutoScale::snap(1.0001, AutoScale::POW2) == 2);
+  CHECK(AutoScale::snap(8, AutoScale::POW2) == 8);
+  CHECK(AutoScale::snap(8.0001, AutoScale::POW2) == 16);
+  CHECK(AutoScale::snap(1024, AutoScale::POW2) == 1024);
+  CHECK(AutoScale::snap(1025, AutoScale::POW2) == 2048);
+  CHECK(AutoScale::snap(0.5, AutoScale::POW2) == 0.5);
+  CHECK(AutoScale::snap(0.5001, AutoScale::POW2) == 1);
+
+  CHECK(AutoScale::snap(1, AutoScale::STEPS125) == 1);
+  CHECK(AutoScale::snap(1.001, AutoScale::STEPS125) == 2);
+  CHECK(AutoScale::snap(100, AutoScale::STEPS125) == 100);
+  CHECK(AutoScale::snap(100.001, AutoScale::STEPS125) == 200);
+  CHECK(AutoScale::snap(200, AutoScale::STEPS125) == 200);
+  CHECK(AutoScale::snap(200.001, AutoScale::STEPS125) == 500);
+  CHECK(AutoScale::snap(500, AutoScale::STEPS125) == 500);
+  CHECK(AutoScale::snap(500.001, AutoScale::STEPS125) == 1000);
+  CHECK(AutoScale::snap(1000, AutoScale::STEPS125) == 1000);
+  CHECK(AutoScale::snap(1000000, AutoScale::STEPS125) == 1000000);
+  CHECK(AutoScale::snap(1000001, AutoScale::STEPS125) == 2000000);
+
+  CHECK(AutoScale::snap(123.4, AutoScale::NONE) == 123.4);
+  CHECK(AutoScale::snap(0, AutoScale::POW2) == 0);
+  CHECK(AutoScale::snap(0, AutoScale::STEPS125) == 0);
+}
+
+int main( void ){
+  window();
+  hysteresis();
+  floor();
+  latest();
+  snap();
+
+  return checked("autoscale");
+}
@@ -0,0 +1,31 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _CHECK_H_
+#define _CHECK_H_
+
+//  What the tests run by make check share: CHECK() counts and reports
+//  the checks that fail, and main() ends with return checked("name").
+
+#include <stdio.h>
+
+static int failures = 0;
+
+#define CHECK(cond) { \
+  if (!(cond)) { \
+    fprintf(stderr, "%s:%d: failed: %s\n", __FILE__, __LINE__, #cond); \
+    failures++; \
+  } \
+}
+
+//  The exit status of a test: 1 if any check failed.
+static inline int checked( const char *name ){
+  if (failures)
+    fprintf(stderr, "%s: %d checks failed\n", name, failures);
+  return failures ? 1 : 0;
+}
+
+#endif
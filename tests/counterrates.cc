@@ -0,0 +1,129 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+//  CounterRates on synthetic counter sequences: priming, wrap at 32
+//  and 64 bits, reset, and restart().  Run by make check.
+
+#include "counterrates.h"
+#include "check.h"
+
+static const unsigned long long SEC = 1000000000ULL;
+
+static void priming( void ){
+  CounterRates r(2);
+  unsigned long long c[2] = { 1000000, 5 };
+
+  //  Everything counted since boot is not a rate.
+  CHECK(!r.update(c, 1 * SEC));
+  CHECK(r.delta(0) == 0 && r.delta(1) == 0);
+  CHECK(r.rate(0) == 0 && r.secs() == 0);
+
+  c[0] += 500;
+  c[1] += 2;
+  CHECK(r.update(c, 3 * SEC));
+  CHECK(r.delta(0) == 500 && r.delta(1) == 2);
+  CHECK(r.secs() == 2);
+  CHECK(r.rate(0) == 250 && r.rate(1) == 1);
+  CHECK(r.last(0) == 1000500);
+  CHECK(r.wraps() == 0 && r.resets() == 0);
+
+  //  Counters added later start unprimed, the others carry on.
+  r.resize(3);
+  unsigned long long d[3] = { 1000600, 7, 42 };
+  CHECK(r.update(d, 4 * SEC));
+  CHECK(r.delta(0) == 100 && r.delta(1) == 0 && r.delta(2) == 0);
+  d[2] += 8;
+  CHECK(r.update(d, 5 * SEC));
+  CHECK(r.delta(2) == 8);
+}
+
+static void wrap32( void ){
+  CounterRates r(1, 32);
+  unsigned long long c = 0xffffff00ULL;
+
+  r.update(&c, 1 * SEC);
+  c = 0x10;
+  CHECK(r.update(&c, 2 * SEC));
+  CHECK(r.delta(0) == 0x110);
+  CHECK(r.wraps() == 1 && r.resets() == 0);
+}
+
+static void wrap64( void ){
+  CounterRates r(1);
+  unsigned long long c = ~0ULL - 99;
+
+  r.update(&c, 1 * SEC);
+  c = 50;
+  CHECK(r.update(&c, 2 * SEC));
+  CHECK(r.delta(0) == 150);
+  CHECK(r.wraps() == 1 && r.resets() == 0);
+}
+
+static void reset( void ){
+  CounterRates r(2, 32);
+  unsigned long long c[2] = { 1500000000ULL, 1000000000ULL };
+
+  r.update(c, 1 * SEC);
+  //  Back to (near) zero: a wrap would be more than half the range, or
+  //  in the 64 bit case the counter was wider than 32 bits.
+  c[0] = 0;
+  c[1] = 10;
+  CHECK(r.update(c, 2 * SEC));
+  CHECK(r.delta(0) == 0 && r.delta(1) == 0);
+  CHECK(r.resets() == 2 && r.wraps() == 0);
+
+  //  And it counts from the new value on.
+  c[0] += 20;
+  c[1] += 30;
+  CHECK(r.update(c, 3 * SEC));
+  CHECK(r.delta(0) == 20 && r.delta(1) == 30);
+
+  CounterRates wide(1);
+  unsigned long long w = 5000000000ULL;
+  wide.update(&w, 1 * SEC);
+  w = 0;
+  CHECK(wide.update(&w, 2 * SEC));
+  CHECK(wide.delta(0) == 0 && wide.resets() == 1);
+}
+
+static void restart( void ){
+  CounterRates r(2);
+  unsigned long long c[2] = { 100, 200 };
+
+  r.update(c, 1 * SEC);
+  c[0] = 110;
+  c[1] = 210;
+  r.update(c, 2 * SEC);
+
+  //  One counter forgotten: it is primed again, the other carries on.
+  r.restart(0);
+  c[0] = 5000;
+  c[1] = 230;
+  CHECK(r.update(c, 3 * SEC));
+  CHECK(r.delta(0) == 0 && r.delta(1) == 20);
+  CHECK(r.resets() == 0);
+
+  //  All forgotten: the next update() is a first one again.
+  r.restart();
+  c[0] = 6000;
+  c[1] = 10;
+  CHECK(!r.update(c, 4 * SEC));
+  CHECK(r.delta(0) == 0 && r.delta(1) == 0 && r.secs() == 0);
+  c[0] += 1;
+  c[1] += 1;
+  CHECK(r.update(c, 6 * SEC));
+  CHECK(r.delta(0) == 1 && r.delta(1) == 1 && r.secs() == 2);
+}
+
+int main( void ){
+  priming();
+  wrap32();
+  wrap64();
+  reset();
+  restart();
+
+  return checked("counterrates");
+}
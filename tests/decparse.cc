@@ -0,0 +1,117 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+//  decparse() against strtoull(), and the SSE4.2 path (where the cpu
+//  has it) against the scalar one: numbers of 1 to 25 digits, with
+//  leading zeros, overflowing 64 bits, and right up against the end of
+//  a page.  Run by make check.
+
+#include "decparse.h"
+#include "check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+//  Checks one number, the digits at str followed by whatever is there.
+static void check( const char *str ){
+  char *end;
+  unsigned long long want = strtoull(str, &end, 10);
+  unsigned long long got;
+
+  const char *cur = decparseScalar(str, &got);
+  if (got != want || cur != end) {
+    fprintf(stderr, "scalar: \"%.*s\" gave %llu, not %llu\n",
+            (int)(end - str), str, got, want);
+    failures++;
+  }
+#ifdef DECPARSE_SSE
+  if (decparseHaveSSE()) {
+    cur = decparseSSE(str, &got);
+    if (got != want || cur != end) {
+      fprintf(stderr, "sse: \"%.*s\" gave %llu, not %llu\n",
+              (int)(end - str), str, got, want);
+      failures++;
+    }
+  }
+#endif
+}
+
+static void digits( char *buf, int n ){
+  buf[0] = '1' + rand() % 9;
+  for (int i = 1 ; i < n ; i++)
+    buf[i] = '0' + rand() % 10;
+}
+
+static void lengths( void ){
+  char buf[64];
+
+  for (int len = 1 ; len <= 25 ; len++)
+    for (int k = 0 ; k < 2000 ; k++) {
+      digits(buf, len);
+      strcpy(buf + len, k & 1 ? " 123" : "\n");
+      check(buf);
+    }
+
+  check("0");
+  check("0000000000000000000000000042 ");
+  check("18446744073709551615");   // the largest
+  check("18446744073709551616");   // one more
+  check("99999999999999999999");
+  check("184467440737095516150");
+  check("1234567890123456789012345678901234567890");
+}
+
+//  The SSE path must not load past the end of a page, the next one
+//  here is not mapped.
+static void pageEnd( void ){
+  char *page = (char *)mmap(NULL, 8192, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (page == MAP_FAILED) {
+    perror("mmap");
+    failures++;
+    return;
+  }
+  munmap(page + 4096, 4096);
+
+  for (int len = 1 ; len <= 20 ; len++)
+    for (int gap = 1 ; gap <= 20 ; gap++) {
+      char *str = page + 4096 - len - gap;
+      digits(str, len);
+      memset(str + len, ' ', gap - 1);
+      str[len + gap - 1] = '\0';
+      check(str);
+    }
+  munmap(page, 4096);
+}
+
+static void columns( void ){
+  const char *line = "cpu0 10 0020 30\t40  18446744073709551616 6\nfoo";
+  unsigned long long vals[8];
+  const char *end;
+
+  CHECK(decparse(line + 4, vals, 8, &end) == 6);
+  CHECK(vals[0] == 10 && vals[1] == 20 && vals[2] == 30 && vals[3] == 40);
+  CHECK(vals[4] == ~0ULL && vals[5] == 6);
+  CHECK(*end == '\n');
+
+  CHECK(decparse(line + 4, vals, 2, &end) == 2);
+  CHECK(!strncmp(end, " 30", 3));
+
+  CHECK(decparse("  cpu", vals, 8, &end) == 0);
+  CHECK(!decparse("  x1", vals));
+  end = decparse("  42:", vals);
+  CHECK(end && *end == ':' && vals[0] == 42);
+}
+
+int main( void ){
+  srand(1);
+  lengths();
+  pageEnd();
+  columns();
+
+  return checked("decparse");
+}
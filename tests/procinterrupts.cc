@@ -0,0 +1,126 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+//  The irq x cpu matrix of ProcInterrupts, from a file laid out like
+//  the /proc/interrupts of a large machine (many times the 4 KB that
+//  procfs hands over in one read), then again with irqs freed and with
+//  cpus gone.  Run by make check.
+
+#include "procinterrupts.h"
+#include "xosview.h"
+#include "check.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+
+//  ProcFile counts its syscalls per tick, which needs no XOSView here.
+unsigned long XOSView::tick( void ) const { return 0; }
+
+struct Irq {
+  int irq;
+  std::vector<unsigned long long> counts;
+};
+
+static unsigned long long counter( void ){
+  return (unsigned long long)rand() * rand() % 100000000000ULL;
+}
+
+//  Writes a file of ncpus columns and irqs numbered irqs, followed by
+//  the named lines that are to be skipped.
+static std::vector<Irq> write( const char *filename, int ncpus,
+                               const std::vector<int> &irqs ){
+  std::vector<Irq> rval;
+  FILE *f = fopen(filename, "w");
+
+  fprintf(f, "     ");
+  for (int c = 0 ; c < ncpus ; c++) {
+    char name[16];
+    snprintf(name, sizeof(name), "CPU%d", c);
+    fprintf(f, " %10s", name);
+  }
+  fprintf(f, "\n");
+  for (unsigned int i = 0 ; i < irqs.size() ; i++) {
+    Irq irq;
+    irq.irq = irqs[i];
+    fprintf(f, "%4d:", irq.irq);
+    for (int c = 0 ; c < ncpus ; c++) {
+      irq.counts.push_back(counter());
+      fprintf(f, " %10llu", irq.counts.back());
+    }
+    fprintf(f, "  IR-PCI-MSI %d-edge      eth0-TxRx-%d\n", irq.irq, i);
+    rval.push_back(irq);
+  }
+  fprintf(f, " NMI:");
+  for (int c = 0 ; c < ncpus ; c++)
+    fprintf(f, " %10d", 5);
+  fprintf(f, "   Non-maskable interrupts\n ERR:          0\n");
+  fclose(f);
+  return rval;
+}
+
+static void compare( ProcInterrupts &pi, int ncpus,
+                     const std::vector<Irq> &want ){
+  CHECK(pi.cpus() == ncpus);
+  CHECK(pi.rows() == (int)want.size());
+  if (pi.cpus() != ncpus || pi.rows() != (int)want.size())
+    return;
+
+  unsigned long long total = 0;
+  for (int r = 0 ; r < pi.rows() ; r++) {
+    unsigned long long sum = 0;
+    CHECK(pi.irq(r) == want[r].irq);
+    for (int c = 0 ; c < ncpus ; c++) {
+      CHECK(pi.counts(r)[c] == want[r].counts[c]);
+      sum += want[r].counts[c];
+    }
+    CHECK(pi.sum(r, ncpus) == sum);
+    CHECK(pi.sum(r, 1) == want[r].counts[0]);
+    total += sum;
+  }
+  CHECK(pi.total() == total);
+}
+
+int main( void ){
+  char filename[] = "/tmp/xosview-interrupts-XXXXXX";
+  int fd = mkstemp(filename);
+  if (fd < 0) {
+    perror("mkstemp");
+    return 1;
+  }
+  close(fd);
+  srand(1);
+
+  std::vector<int> irqs;
+  for (int i = 0 ; i < 40 ; i++)
+    irqs.push_back(i);
+  for (int i = 120 ; i < 420 ; i++)
+    irqs.push_back(i);
+
+  ProcInterrupts pi(filename);
+  std::vector<Irq> want = write(filename, 96, irqs);
+  pi.update(1);
+  compare(pi, 96, want);
+
+  //  Read again only on the next tick.
+  std::vector<Irq> next = write(filename, 96, irqs);
+  pi.update(1);
+  compare(pi, 96, want);
+  pi.update(2);
+  compare(pi, 96, next);
+
+  //  Irqs freed, and cpus gone.
+  irqs.resize(200);
+  want = write(filename, 96, irqs);
+  pi.update(3);
+  compare(pi, 96, want);
+  want = write(filename, 64, irqs);
+  pi.update(4);
+  compare(pi, 64, want);
+
+  unlink(filename);
+  return checked("procinterrupts");
+}
@@ -10,12 +10,13 @@
 //
 //                 General purpose interval timer class
 //
-//  Implemented using BSD derived function gettimeofday for greater resolution
+//  Implemented on the monotonic clock (where there is one), so that the
+//  intervals are not thrown off by the wall clock being set or slewed.
 //
 //   Author : Mike Romberg
 
-#include "timeval.h"
 #include <sys/time.h>
+#include <time.h>
 #include <iostream>
 
 
@@ -24,25 +25,44 @@ public:
   Timer( int start = 0 ) { if ( start ) Timer::start(); }
   ~Timer( void ){}
 
-  void start( void ) { gettimeofday( &starttime_, NULL ); }
-  void stop( void )  { gettimeofday( &stoptime_, NULL );  }
+  void start( void ) { now( &starttime_ ); }
+  void stop( void )  { now( &stoptime_ );  }
 
-  //  This one uses doubles as the return value, to avoid
+  //  These use doubles as the return value, to avoid
   //  overflow/sign problems.
-  double report_usecs(void) const {
-    return (stoptime_.tv_sec - starttime_.tv_sec) * 1000000.0
-      + stoptime_.tv_usec - starttime_.tv_usec;
+  double report_nsecs(void) const {
+    return (stoptime_.tv_sec - starttime_.tv_sec) * 1e9
+      + stoptime_.tv_nsec - starttime_.tv_nsec;
+  }
+  double report_usecs(void) const { return report_nsecs() / 1e3; }
+
+  static void now( struct timespec *ts ) {
+#ifdef CLOCK_MONOTONIC
+    clock_gettime( CLOCK_MONOTONIC, ts );
+#else
+    struct timeval tv;
+    gettimeofday( &tv, NULL );
+    ts->tv_sec = tv.tv_sec;
+    ts->tv_nsec = tv.tv_usec * 1000;
+#endif
+  }
+  static unsigned long long nsecs( void ) {
+    struct timespec ts;
+    now( &ts );
+    return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
   }
 
   std::ostream &printOn(std::ostream &os) const {
     return os <<"Timer : ["
-      <<"starttime_ = " <<TimeVal(starttime_)
-      <<", stoptime_ = " <<TimeVal(stoptime_)
+      <<"starttime_ = (" <<starttime_.tv_sec <<" sec, "
+      <<starttime_.tv_nsec <<" nsec)"
+      <<", stoptime_ = (" <<stoptime_.tv_sec <<" sec, "
+      <<stoptime_.tv_nsec <<" nsec)"
       <<", duration = " <<report_usecs() <<" usecs]";
   }
 
 protected:
-  struct timeval starttime_, stoptime_;
+  struct timespec starttime_, stoptime_;
 
 private:
 };
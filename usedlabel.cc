@@ -0,0 +1,45 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#include "usedlabel.h"
+#include "xwin.h"
+#include <string.h>
+
+
+void UsedLabel::draw( XWin *win, int x, int baseline, int offset,
+                      unsigned long pixel, const char *text, int mandatory ){
+  int onechar = win->textWidth( "X", 1 );
+  int top = baseline - win->textHeight();
+  int len = strlen( text );
+  int cell = win->glyphCell();
+  int cells = cell ? (offset + 2) / cell - 1 : 0;
+  bool glyphs = ( cell && len <= cells && cells <= MAXCELLS );
+
+  for ( int i = 0 ; glyphs && i < len ; i++ )
+    glyphs = win->isGlyph( text[i] );
+
+  if ( !glyphs || !valid_ || mandatory || pixel != pixel_ ){
+    win->clear( x - offset, top, offset - onechar / 2,
+                win->textHeight() + 1 );
+    memset( shown_, ' ', sizeof(shown_) );
+  }
+  if ( !glyphs ){
+    win->setForeground( pixel );
+    win->drawString( x - (len + 1) * onechar + 2, baseline, text );
+    valid_ = false;
+    return;
+  }
+
+  for ( int i = 0 ; i < cells ; i++ ){
+    char c = ( i < len ? text[len - 1 - i] : ' ' );
+    if ( c != shown_[i] ){
+      win->drawGlyph( pixel, c, x - (i + 2) * cell + 2, top );
+      shown_[i] = c;
+    }
+  }
+  valid_ = true;
+  pixel_ = pixel;
+}
@@ -0,0 +1,35 @@
+//
+//  Copyright (c) 2026 by the xosview authors
+//
+//  This file may be distributed under terms of the GPL
+//
+
+#ifndef _USEDLABEL_H_
+#define _USEDLABEL_H_
+
+class XWin;
+
+//
+//  The "used" number to the left of a meter.  It is right aligned, in
+//  character cells ending one character left of the meter.  Where the
+//  window allows (see XWin::glyphCell()) the characters are copied from
+//  glyph strips, and only the cells that changed since the last draw()
+//  are copied.  Otherwise the label is cleared and drawn as a string.
+//
+class UsedLabel {
+public:
+  UsedLabel( void ) : valid_(false), pixel_(0) {}
+
+  //  x is the left edge of the meter, baseline its bottom, and offset
+  //  how far left of x the label area starts.
+  void draw( XWin *win, int x, int baseline, int offset,
+             unsigned long pixel, const char *text, int mandatory );
+
+private:
+  enum { MAXCELLS = 16 };
+  char shown_[MAXCELLS];  //  Character in each cell, from the right
+  bool valid_;
+  unsigned long pixel_;
+};
+
+#endif
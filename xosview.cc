@@ -7,6 +7,8 @@
 #include "xosview.h"
 #include "meter.h"
 #include "MeterMaker.h"
+#include "timer.h"
+#include "recorder.h"
 #if ( defined(XOSVIEW_NETBSD) || defined(XOSVIEW_FREEBSD) || \
       defined(XOSVIEW_OPENBSD) || defined(XOSVIEW_DFBSD) )
 # include "kernel.h"
@@ -15,7 +17,11 @@
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+#include <signal.h>
 #include <iostream>
+#include <X11/keysym.h>
 
 static const char * const versionString = "xosview version: Git";
 
@@ -59,16 +65,21 @@ static const char NAME[] = "xosview@";
 
 double MAX_SAMPLES_PER_SECOND = 10;
 
-XOSView::XOSView( const char * instName, int argc, char *argv[] ) : XWin(),
+XOSView::XOSView( const char * instName, int argc, char *argv[],
+                  const char *recordFile ) : XWin(),
 						xrm(Xrm("xosview", instName)){
   // Check for version arguments first.  This allows
   // them to work without the need for a connection
   // to the X server
   checkVersion(argc, argv);
 
-  setDisplayName (xrm.getDisplayName( argc, argv));
-  openDisplay();  //  So that the Xrm class can contact the display for its
-		  //  default values.
+  //  Recording needs no display at all.
+  recorder_ = recordFile ? new Recorder(recordFile) : NULL;
+  if ( !recorder_ ) {
+    setDisplayName (xrm.getDisplayName( argc, argv));
+    openDisplay();  //  So that the Xrm class can contact the display for its
+		    //  default values.
+  }
   //  The resources need to be initialized before calling XWinInit, because
   //  XWinInit looks at the geometry resource for its geometry.  BCG
   xrm.loadAndMergeResources (argc, argv, display_);
@@ -78,13 +89,40 @@ XOSView::XOSView( const char * instName, int argc, char *argv[] ) : XWin(),
   if (!MAX_SAMPLES_PER_SECOND)
     MAX_SAMPLES_PER_SECOND = 10;
 #endif
-  usleeptime_ = (unsigned long) (1000000/MAX_SAMPLES_PER_SECOND);
-  if (usleeptime_ >= 1000000) {
-    /*  The syscall usleep() only takes times less than 1 sec, so
-     *  split into a sleep time and a usleep time if needed.  */
-    sleeptime_ = usleeptime_ / 1000000;
-    usleeptime_ = usleeptime_ % 1000000;
-  } else { sleeptime_ = 0; }
+  pacer_.period(1.0/MAX_SAMPLES_PER_SECOND);
+  obscuredDivisor_ = MAX(1, atoi(getResource("obscuredSampleDivisor")));
+
+  //  remoteMode is Auto, True or False.
+  const char *remote = getResource("remoteMode");
+  if (!strncasecmp(remote, "auto", 4))
+    XWin::remote(remoteDisplay());
+  else
+    XWin::remote(isResourceTrue("remoteMode"));
+  maxBytesPerSec_ = atof(getResource("maxXBytesPerSec"));
+
+  //  Draw every frameDivisor_ passes, framesPerSec times a second.  A
+  //  remote display gets 2 frames a second, unless told otherwise.
+  double fps = atof(getResource("framesPerSec"));
+  if (fps <= 0 && XWin::remote())
+    fps = 2;
+  frameDivisor_ = ( fps > 0 ? MAX(1, (int)(MAX_SAMPLES_PER_SECOND / fps + 0.5))
+                            : 1 );
+  baseFrameDivisor_ = frameDivisor_;
+  labelsDue_ = true;
+  XOSDEBUG("%s display, a frame every %d samples.\n",
+           XWin::remote() ? "Remote" : "Local", frameDivisor_);
+
+  //  The graphs' history, and how far the scroll keys move through it.
+  const char *tiers = getResource("historyTiers");
+  if (!isResourceTrue("history"))
+    tiers = "";
+  if (!History::parse(tiers, historyTiers_)) {
+    std::cerr << "Bad historyTiers: " << tiers << std::endl;
+    exit(1);
+  }
+  historyZoom_ = historyBack_ = 0;
+  historyStep_ = MAX(1, atoi(getResource("graphNumCols")) / 2);
+  samplerPacer_.period(1.0/MAX_SAMPLES_PER_SECOND);
 #if ( defined(XOSVIEW_NETBSD) || defined(XOSVIEW_FREEBSD) || \
       defined(XOSVIEW_OPENBSD) || defined(XOSVIEW_DFBSD) )
   BSDInit();	/*  Needs to be done before processing of -N option.  */
@@ -102,10 +140,19 @@ XOSView::XOSView( const char * instName, int argc, char *argv[] ) : XWin(),
   yoff_ = 0;
   nummeters_ = 0;
   meters_ = NULL;
+  tick_ = 0;
+  rateStart_ = 0;
+  exposed_ = 0;
+  damage_ = XCreateRegion();
+  sampler_ = false;
+  samplerTick_ = 0;
+  samplerStop_ = 0;
   name_ = const_cast<char *>("xosview");
   _deferred_resize = true;
   _deferred_redraw = true;
+  _deferred_expose = false;
   windowVisibility = OBSCURED;
+  obscured_ = 1;
 
   //  set up the X events
   addEvent( new Event( this, ConfigureNotify,
@@ -137,10 +184,14 @@ XOSView::XOSView( const char * instName, int argc, char *argv[] ) : XWin(),
 
   //  Have the meters re-check the resources.
   checkMeterResources();
+  if ( recorder_ )
+    return;
 
   // determine the width and height of the window then create it
   figureSize();
   init( argc, argv );
+  if ( isResourceTrue("backBuffer") )
+    setupBackBuffer();
   title( winname() );
   iconname( winname() );
   dolegends();
@@ -237,7 +288,8 @@ void XOSView::checkOverallResources() {
   //    the value in the defaultXResourceString is the default value.
   usedlabels_ = legend_ = caption_ = 0;
 
-  setFont();
+  if ( !recorder_ )
+    setFont();
 
    // use captions
   if ( isResourceTrue("captions") )
@@ -275,6 +327,8 @@ void  XOSView::resize( void ){
         ) / nummeters_;
   newheight = (newheight >= 2) ? newheight : 2;
 
+  if (backBuffered())
+    setupBackBuffer();
 
   int counter = 1;
   MeterNode *tmp = meters_;
@@ -290,6 +344,7 @@ void  XOSView::resize( void ){
 
 
 XOSView::~XOSView( void ){
+  delete recorder_;
   MeterNode *tmp = meters_;
   while ( tmp != NULL ){
     MeterNode *save = tmp->next_;
@@ -297,10 +352,11 @@ XOSView::~XOSView( void ){
     delete tmp;
     tmp = save;
   }
+  XDestroyRegion(damage_);
 }
 
 void XOSView::draw(void) {
-  if (windowVisibility != OBSCURED) {
+  if (getWindowVisibilityState() != OBSCURED) {
     MeterNode *tmp = meters_;
 
     XOSDEBUG("Doing draw.\n");
@@ -316,8 +372,39 @@ void XOSView::draw(void) {
   }
 }
 
+//  Redraw only the meters whose part of the window was exposed.  That
+//  is the full width of the window (for the legends), from below the
+//  meter above down to the bottom of this one (for the captions).  The
+//  X server has already cleared the exposed area.
+void XOSView::drawExposed(void) {
+  int spacing = vspacing_+1;
+
+  for (MeterNode *tmp = meters_ ; tmp != NULL ; tmp = tmp->next_) {
+    Meter *m = tmp->meter_;
+    int top = m->getY() - yoff_ - spacing;
+
+    if (XRectInRegion(damage_, 0, top, width_,
+                      m->getY() + m->getHeight() + 1 - top) != RectangleOut) {
+      XOSDEBUG("Redrawing exposed %s.\n", m->name());
+      m->draw();
+    }
+  }
+}
+
 void XOSView::run( void ){
+  if ( recorder_ ){
+    record();
+    return;
+  }
+
+  unsigned long requests = 0;  //  X requests made by the meter updates
+  startSampler();
+  pacer_.fd();  //  wait on a timerfd, where there is one
+
   while(!done_) {
+    unsigned long request = nextRequest();
+    bool updated = false;
+
     // Check for X11 events
     checkevent();
 
@@ -328,27 +415,249 @@ void XOSView::run( void ){
       _deferred_redraw = true;
     }
 
-    // redraw everything if needed
+    // redraw everything if needed, or just what was exposed
     if (_deferred_redraw) {
       draw();
       _deferred_redraw = false;
     }
+    else if (_deferred_expose)
+      drawExposed();
+    if (_deferred_expose) {
+      XDestroyRegion(damage_);
+      damage_ = XCreateRegion();
+      _deferred_expose = false;
+    }
 
     // Update the metrics & meters
-    MeterNode *tmp = meters_;
-    while ( tmp != NULL ){
-      if ( tmp->meter_->requestevent() )
-        tmp->meter_->checkevent();
-      tmp = tmp->next_;
+    if (pacer_.due()) {
+      updated = true;
+      tick_++;
+      //  The meters that can sample apart from drawing do so at their
+      //  own rate and draw on frames, the others only run on frames.
+      bool frame = !(tick_ % frameDivisor_);
+      if (frame)
+        throttle();
+      MeterNode *tmp = meters_;
+      while ( tmp != NULL ){
+        Meter *m = tmp->meter_;
+        if ( m->threaded() ) {
+          if ( frame )
+            m->render();
+        }
+        else if ( m->splitSample() ) {
+          if ( m->requestevent(slowdown()) ) {
+            m->sample();
+            m->publish();
+          }
+          if ( frame )
+            m->render();
+        }
+        else if ( frame && m->requestevent(slowdown()) )
+          m->checkevent();
+        tmp = tmp->next_;
+      }
     }
 
     flush();
+    if (updated)
+      requests += nextRequest() - request;
+    if (exposed_ && !_deferred_redraw) {
+      XOSDEBUG("Expose answered in %.3f ms.\n",
+               (Timer::nsecs() - exposed_) / 1e6);
+      exposed_ = 0;
+    }
+
+    waitevent();
+  }
+
+  stopSampler();
+  XOSDEBUG("Missed %lu of %lu deadlines.\n", pacer_.missed(), tick_);
+  XOSDEBUG("Filled %lu rectangles in %lu requests.\n",
+           fillRects(), fillRequests());
+  XOSDEBUG("Sent %lu GC changes, skipped %lu.\n", gcChanges(), gcSkipped());
+  XOSDEBUG("%.1f X requests per update.\n",
+           tick_ ? (double)requests / tick_ : 0.0);
+}
+
+static volatile sig_atomic_t recordStop = 0;
+
+static void stopRecording( int ){
+  recordStop = 1;
+}
+
+//  Sample the meters into the record file until killed.  Only the
+//  meters that can sample without drawing (splitSample()) can be
+//  recorded, the others are left out and named in the header.
+void XOSView::record( void ){
+  for ( MeterNode *tmp = meters_ ; tmp != NULL ; tmp = tmp->next_ ){
+    Meter *m = tmp->meter_;
+    if ( m->splitSample() && m->numValues() )
+      recorder_->add(m);
+    else {
+      recorder_->skip(m);
+      std::cerr << "Not recording " << m->name()
+                << " : it can not be sampled without a display." << std::endl;
+    }
+  }
+  if ( !recorder_->meters() ){
+    std::cerr << "No meters to record!  Exiting..." << std::endl;
+    exit(1);
+  }
+
+  signal(SIGINT, stopRecording);
+  signal(SIGTERM, stopRecording);
+  signal(SIGHUP, stopRecording);
+  recorder_->start(MAX_SAMPLES_PER_SECOND, atof(getResource("recordSync")));
+
+  while ( !done_ && !recordStop ){
+    bool sampled = false;
+    tick_++;
+    for ( MeterNode *tmp = meters_ ; tmp != NULL ; tmp = tmp->next_ ){
+      Meter *m = tmp->meter_;
+      if ( m->splitSample() && m->numValues() && m->requestevent() ){
+        m->sample();
+        sampled = true;
+      }
+    }
+    if ( sampled )
+      recorder_->frame(Timer::nsecs());
+
+    pacer_.wait();
+  }
+
+  recorder_->finish();
+  XOSDEBUG("Missed %lu of %lu deadlines.\n", pacer_.missed(), tick_);
+}
+
+//  Sleep until there is an X event to handle or the meters are due.
+//  An Expose is so answered within about a millisecond, where it used to
+//  wait for the next sample (half a period on average).
+void XOSView::waitevent( void ){
+  struct pollfd fds[2];
+  int nfds = 0;
+
+  //  Xlib may already have read events off the connection.
+  if ( XEventsQueued(display_, QueuedAlready) )
+    return;
+
+  fds[nfds].fd = ConnectionNumber(display_);
+  fds[nfds++].events = POLLIN;
+  if ( pacer_.fd() >= 0 ){
+    fds[nfds].fd = pacer_.fd();
+    fds[nfds++].events = POLLIN;
+  }
+  if ( poll(fds, nfds, pacer_.timeout()) < 0 && errno != EINTR ){
+    std::cerr << "poll() failed : " << strerror(errno) << std::endl;
+    done(1);
+  }
+}
 
-    /*  First, sleep for the proper integral number of seconds --
-     *  usleep only deals with times less than 1 sec.  */
-    if (sleeptime_) sleep((unsigned int)sleeptime_);
-    if (usleeptime_) usleep( (unsigned int)usleeptime_);
+//  Once a second, see how much has been sent to the X server.  In
+//  remote mode the used labels are only redrawn then, and the frames
+//  come further apart while more than maxXBytesPerSec is sent, and
+//  closer together again (up to framesPerSec) when well under it.
+void XOSView::throttle( void ){
+  unsigned long long now = Timer::nsecs();
+
+  labelsDue_ = !XWin::remote();
+  if (rateStart_ && now - rateStart_ < 1000000000ULL)
+    return;
+
+  if (rateStart_) {
+    double secs = (now - rateStart_) / 1e9;
+    double bytes = (bytesSent() - rateBytes_) / secs;
+    XOSDEBUG("%.0f X requests and about %.0f bytes a second.\n",
+             (nextRequest() - rateRequests_) / secs, bytes);
+
+    labelsDue_ = true;
+    if (XWin::remote() && maxBytesPerSec_ > 0) {
+      //  At least one frame every 10 seconds.
+      if (bytes > maxBytesPerSec_
+          && frameDivisor_ * 2 <= 10 * MAX_SAMPLES_PER_SECOND)
+        frameDivisor_ *= 2;
+      else if (bytes < maxBytesPerSec_ / 4
+               && frameDivisor_ > baseFrameDivisor_)
+        frameDivisor_ = MAX(baseFrameDivisor_, frameDivisor_ / 2);
+    }
   }
+  rateStart_ = now;
+  rateBytes_ = bytesSent();
+  rateRequests_ = nextRequest();
+}
+
+//  While the window is hidden the meters are sampled less often, and
+//  catch up on the graph columns they missed when they are next drawn.
+int XOSView::slowdown( void ) const {
+  return ( __atomic_load_n(&obscured_, __ATOMIC_RELAXED)
+           ? obscuredDivisor_ : 1 );
+}
+
+void XOSView::setVisibility( enum windowVisibilityState state ){
+  windowVisibility = state;
+  __atomic_store_n(&obscured_, state == OBSCURED, __ATOMIC_RELAXED);
+}
+
+unsigned long XOSView::tick( void ) const {
+  if ( sampler_ && !pthread_equal(pthread_self(), xThread_) )
+    return samplerTick_;
+  return tick_;
+}
+
+//  Hand the meters that can sample without drawing over to a thread of
+//  their own.  The X thread then only draws what they publish.
+void XOSView::startSampler( void ){
+  if ( !isResourceTrue("samplerThread") )
+    return;
+
+  int n = 0;
+  for ( MeterNode *tmp = meters_ ; tmp != NULL ; tmp = tmp->next_ )
+    if ( tmp->meter_->splitSample() ){
+      tmp->meter_->threaded(true);
+      n++;
+    }
+  if ( !n )
+    return;
+
+  sampler_ = true;
+  xThread_ = pthread_self();
+  int err = pthread_create(&samplerThread_, NULL, samplerMain, this);
+  if ( err ){
+    std::cerr << "Warning: could not start the sampler thread: "
+              << strerror(err) << std::endl;
+    sampler_ = false;
+    for ( MeterNode *tmp = meters_ ; tmp != NULL ; tmp = tmp->next_ )
+      tmp->meter_->threaded(false);
+    return;
+  }
+  XOSDEBUG("Sampling %d meters in their own thread.\n", n);
+}
+
+void XOSView::stopSampler( void ){
+  if ( !sampler_ )
+    return;
+  __atomic_store_n(&samplerStop_, 1, __ATOMIC_RELEASE);
+  pthread_join(samplerThread_, NULL);
+  sampler_ = false;
+}
+
+void *XOSView::samplerMain( void *xosview ){
+  static_cast<XOSView *>(xosview)->sampleMeters();
+  return NULL;
+}
+
+void XOSView::sampleMeters( void ){
+  while ( !__atomic_load_n(&samplerStop_, __ATOMIC_ACQUIRE) ){
+    samplerTick_++;
+    for ( MeterNode *tmp = meters_ ; tmp != NULL ; tmp = tmp->next_ )
+      if ( tmp->meter_->threaded() && tmp->meter_->requestevent(slowdown()) ){
+        tmp->meter_->sample();
+        tmp->meter_->publish();
+      }
+
+    samplerPacer_.wait();
+  }
+  XOSDEBUG("Sampler missed %lu of %lu deadlines.\n",
+           samplerPacer_.missed(), samplerTick_);
 }
 
 void XOSView::keyPressEvent( XKeyEvent &event ){
@@ -359,6 +668,43 @@ void XOSView::keyPressEvent( XKeyEvent &event ){
 
   if ( (c == 'q') || (c == 'Q') )
     done_ = 1;
+
+  //  Zooming and scrolling the graphs through their history.  A zoom
+  //  keeps the time at the right edge of the graphs where it was.
+  int zoom = historyZoom_, back = historyBack_;
+  int tiers = historyTiers_.size();
+  if ( c == '-' || key == XK_KP_Subtract )
+    zoom = MIN(zoom + 1, tiers);
+  else if ( c == '+' || c == '=' || key == XK_KP_Add )
+    zoom = MAX(zoom - 1, 0);
+  else if ( key == XK_Left || key == XK_KP_Left || key == XK_Prior ){
+    if ( zoom == 0 )
+      zoom = MIN(1, tiers);
+    else
+      back += historyStep_;
+  }
+  else if ( key == XK_Right || key == XK_KP_Right || key == XK_Next )
+    back = MAX(back - historyStep_, 0);
+  else if ( key == XK_Home || key == XK_Escape )
+    zoom = back = 0;
+  else
+    return;
+
+  if ( zoom == 0 )
+    back = 0;
+  else {
+    const History::Tier &tier = historyTiers_[zoom - 1];
+    if ( zoom != historyZoom_ && historyZoom_ > 0 )
+      back = (int)( back * (double)historyTiers_[historyZoom_ - 1].nsecs
+                    / tier.nsecs );
+    back = MIN(back, MAX(tier.cols - historyStep_, 0));
+  }
+  if ( zoom != historyZoom_ || back != historyBack_ ){
+    historyZoom_ = zoom;
+    historyBack_ = back;
+    XOSDEBUG("History zoom %d, %d columns back.\n", zoom, back);
+    _deferred_redraw = true;
+  }
 }
 
 void XOSView::checkArgs (int argc, char** argv) const
@@ -384,6 +730,17 @@ void XOSView::checkArgs (int argc, char** argv) const
 		  argc--;
 		}
 		break;
+      case '-': //  --record was parsed by main(), and so was
+      case 'r': //  -record.
+		if (!strcmp(*argv, "--record")
+		    || !strcmp(*argv, "-record"))
+		{
+		  argv++;	//  Skip the file.
+		  argc--;
+		  break;
+		}
+		std::cerr << "Ignoring unknown option '" << argv[0] << "'.\n";
+		break;
 #if ( defined(XOSVIEW_NETBSD) || defined(XOSVIEW_FREEBSD) || \
       defined(XOSVIEW_OPENBSD) || defined(XOSVIEW_DFBSD) )
       case 'N': if (strlen(argv[0]) > 2)
@@ -407,7 +764,23 @@ void XOSView::checkArgs (int argc, char** argv) const
 }
 
 void XOSView::exposeEvent(XExposeEvent &event) {
-  _deferred_redraw = true;
+  //  The back buffer already holds what goes there.
+  if (backBuffered())
+    expose(event.x, event.y, event.width, event.height);
+  else {
+    //  Collect the rectangles of a series of Exposes (the last has a
+    //  count of 0) before drawing.
+    XRectangle r;
+    r.x = event.x;
+    r.y = event.y;
+    r.width = event.width;
+    r.height = event.height;
+    XUnionRectWithRegion(&r, damage_, damage_);
+    if (event.count == 0)
+      _deferred_expose = true;
+  }
+  if (!exposed_)
+    exposed_ = Timer::nsecs();
   XOSDEBUG("Got expose event.\n");
 }
 
@@ -432,18 +805,19 @@ void XOSView::resizeEvent( XConfigureEvent &event ) {
 
 void XOSView::visibilityEvent(XVisibilityEvent &event) {
   if (event.state == VisibilityPartiallyObscured) {
-    if (windowVisibility != FULLY_VISIBLE)
+    if (windowVisibility != FULLY_VISIBLE && !backBuffered())
       _deferred_redraw = true;
-    windowVisibility = PARTIALLY_VISIBILE;
+    setVisibility(PARTIALLY_VISIBILE);
   }
   else if (event.state == VisibilityFullyObscured) {
-    windowVisibility = OBSCURED;
-    _deferred_redraw = false;
+    setVisibility(OBSCURED);
+    if (!backBuffered())
+      _deferred_redraw = false;
   }
   else {
-    if (windowVisibility != FULLY_VISIBLE)
+    if (windowVisibility != FULLY_VISIBLE && !backBuffered())
       _deferred_redraw = true;
-    windowVisibility = FULLY_VISIBLE;
+    setVisibility(FULLY_VISIBLE);
   }
 
   XOSDEBUG("Got visibility event: %s\n",
@@ -460,5 +834,5 @@ void XOSView::unmapEvent( XUnmapEvent & ev ){
      we get the unmap event if the cursor is moved again. Don't treat it
      as main window unmap */
   if(ev.window == window_)
-    windowVisibility = OBSCURED;
+    setVisibility(OBSCURED);
 }
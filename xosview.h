@@ -9,30 +9,59 @@
 
 #include "xwin.h"
 #include "Xrm.h"  //  For Xrm resource manager class.
+#include "pacer.h"
+#include "history.h"
 #include <stdio.h>
+#include <pthread.h>
+#include <vector>
 
 /*  Take at most n samples per second (default of 10)  */
 extern double MAX_SAMPLES_PER_SECOND;
 
 class Meter;
+class Recorder;
 
 class XOSView : public XWin {
 public:
-  XOSView( const char* instName, int argc, char *argv[] );
+  //  With a record file there is no display, and run() records the
+  //  meters to the file (see Recorder).
+  XOSView( const char* instName, int argc, char *argv[],
+           const char *recordFile = NULL );
   ~XOSView( void );
 
   void figureSize ( void );
   void resize( void );
   void draw ( void );
+  void drawExposed( void );
   void run( void );
   const char *winname( void );
 
   // used by meter makers
   int xoff(void) const { return xoff_; }
   int newypos( void );
+  //  Counts passes over the meters, so that meters sharing one
+  //  stats file can tell whether it has been read for this pass.
+  //  The sampler thread has a count of its own.
+  unsigned long tick( void ) const;
+  //  Passes over the meters per frame drawn (see framesPerSec).
+  int frameDivisor( void ) const { return frameDivisor_; }
+  //  Whether the used labels are to be redrawn on this frame, which on
+  //  a remote display is only once a second.
+  bool labelsDue( void ) const { return labelsDue_; }
+
+  //  The tiers of the graphs' history (historyTiers), and which part of
+  //  it the graphs show: zoom 0 is the live graph, zoom n is tier n-1,
+  //  back columns before its newest one.
+  const std::vector<History::Tier> &historyTiers( void ) const
+    { return historyTiers_; }
+  int historyZoom( void ) const { return historyZoom_; }
+  int historyBack( void ) const { return historyBack_; }
 
   enum windowVisibilityState { FULLY_VISIBLE, PARTIALLY_VISIBILE, OBSCURED };
-  enum windowVisibilityState getWindowVisibilityState(void) { return windowVisibility; }
+  //  Drawing into the back buffer works the same whether or not the
+  //  window can be seen.
+  enum windowVisibilityState getWindowVisibilityState(void)
+    { return backBuffered() ? FULLY_VISIBLE : windowVisibility; }
 
 protected:
 
@@ -50,9 +79,42 @@ protected:
 
   int caption_, legend_, xoff_, yoff_, nummeters_, usedlabels_;
   int hmargin_, vmargin_, vspacing_;
-  unsigned long sleeptime_, usleeptime_;
+  Pacer pacer_;
+  unsigned long tick_;
+  int obscuredDivisor_;  // sampling slowdown while the window is hidden
+  int frameDivisor_, baseFrameDivisor_;
+  //  Keeping the X traffic down on a remote display (remoteMode).
+  double maxBytesPerSec_;
+  bool labelsDue_;
+  unsigned long long rateStart_;
+  unsigned long rateBytes_, rateRequests_;
+  std::vector<History::Tier> historyTiers_;
+  int historyZoom_, historyBack_, historyStep_;
+  int obscured_;         // windowVisibility == OBSCURED, for the sampler
+  unsigned long long exposed_;  // time of the last unanswered Expose
+  Region damage_;               // exposed since the last drawExposed()
+
+  //  The thread sampling the meters that have splitSample(), if the
+  //  samplerThread resource is set.
+  bool sampler_;
+  pthread_t samplerThread_, xThread_;
+  Pacer samplerPacer_;
+  unsigned long samplerTick_;
+  int samplerStop_;
+
+  Recorder *recorder_;
+  void record( void );
+
+  void startSampler( void );
+  void stopSampler( void );
+  void sampleMeters( void );
+  static void *samplerMain( void *xosview );
 
   void usleep_via_select( unsigned long usec );
+  void waitevent( void );
+  void setVisibility( enum windowVisibilityState state );
+  int slowdown( void ) const;
+  void throttle( void );
   void addmeter( Meter *fm );
   void checkMeterResources( void );
 
@@ -72,6 +134,7 @@ private:
 
   bool _deferred_resize;
   bool _deferred_redraw;
+  bool _deferred_expose;        // damage_ is complete (Expose count 0)
   enum windowVisibilityState windowVisibility;
 };
 
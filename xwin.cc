@@ -12,6 +12,7 @@
 //  argc is a reference, so that the changes to argc by XrmParseCommand are
 //  noticed by the caller (XOSView, in this case).  BCG
 XWin::XWin() {
+  display_ = NULL;
 }
 //-----------------------------------------------------------------------------
 
@@ -46,6 +47,21 @@ void XWin::XWinInit (int argc, char** argv, char* geometry, Xrm* xrm) {
   font_ = NULL;
   done_ = 0;
 
+  drawable_ = None;
+  backbuffer_ = background_ = None;
+  cleargc_ = copygc_ = NULL;
+  glyphCell_ = -1;
+  lineWidth_ = 0;
+  fillgc_ = NULL;
+  gcStipple_ = None;
+  fillStipple_ = -1;
+  gcChanges_ = gcSkipped_ = 0;
+  xbytes_ = 0;
+  remote_ = false;
+  nfills_ = 0;
+  fillRects_ = fillRequests_ = 0;
+  undamage();
+
   // Set up the default Events
   events_ = NULL;
   addEvent( new Event( this, ClientMessage, &XWin::deleteEvent ) );
@@ -64,11 +80,23 @@ XWin::~XWin( void ){
     event = save;
   }
 
+  //  Without a display (see --record) nothing else was set up.
+  if ( display_ == NULL )
+    return;
+
   XFree( title_.value );
   XFree( iconname_.value );
   XFree( sizehints_ );
   XFree( wmhints_ );
   XFree( classhints_ );
+  if ( backbuffer_ != None ){
+    XFreePixmap( display_, backbuffer_ );
+    XFreeGC( display_, cleargc_ );
+  }
+  for ( unsigned int i = 0 ; i < glyphStrips_.size() ; i++ )
+    XFreePixmap( display_, glyphStrips_[i].second );
+  XFreeGC( display_, copygc_ );
+  XFreeGC( display_, fillgc_ );
   XFreeGC( display_, gc_ );
   XFreeFont( display_, font_ );
   XDestroyWindow( display_, window_ );
@@ -103,6 +131,9 @@ void XWin::init( int argc, char **argv ){
   gcv.background = bgcolor_;
   gc_ = XCreateGC(display_, window_,
 		  (GCFont | GCForeground | GCBackground), &gcv);
+  gcForeground_ = fgcolor_;
+  gcBackground_ = bgcolor_;
+  drawable_ = window_;
 
   // Set main window's attributes (colormap, bit_gravity)
   xswa.colormap = colormap_;
@@ -111,8 +142,10 @@ void XWin::init( int argc, char **argv ){
 			  (CWColormap | CWBitGravity), &xswa);
 
   // If there is a pixmap file, set it as the background
-  if (getPixmap(&background_pixmap))
+  if (getPixmap(&background_pixmap)) {
     XSetWindowBackgroundPixmap(display_,window_,background_pixmap);
+    background_ = background_pixmap;
+  }
 
   // add the events
   Event *tmp = events_;
@@ -134,7 +167,16 @@ void XWin::init( int argc, char **argv ){
   stipples_[1] = createPixmap("\002\000\001\000", 2, 4);
   stipples_[2] = createPixmap("\002\001", 2, 2);
   stipples_[3] = createPixmap("\002\003\001\003", 2, 4);
-  doStippling_ = isResourceTrue("enableStipple");
+  doStippling_ = isResourceTrue("enableStipple") && !remote_;
+
+  gcv.background = bgcolor_;
+  gcv.fill_style = doStippling_ ? FillOpaqueStippled : FillSolid;
+  gcv.foreground = fillPixel_ = fgcolor_;
+  fillgc_ = XCreateGC(display_, window_,
+                      (GCForeground | GCBackground | GCFillStyle), &gcv);
+
+  gcv.graphics_exposures = False;
+  copygc_ = XCreateGC(display_, window_, GCGraphicsExposures, &gcv);
 }
 //-----------------------------------------------------------------------------
 
@@ -252,6 +294,221 @@ int XWin::getPixmap(Pixmap *pixmap)
   return 1;
 }
 
+//-----------------------------------------------------------------------------
+
+//  (Re)creates the back buffer at the current size of the window, and
+//  starts drawing into it.  The meters have to redraw everything after
+//  this, since the new back buffer only holds the background.
+void XWin::setupBackBuffer( void ){
+  XGCValues gcv;
+
+  if ( backbuffer_ == None ){
+    if ( background_ != None ){
+      gcv.fill_style = FillTiled;
+      gcv.tile = background_;
+      cleargc_ = XCreateGC( display_, window_, GCFillStyle | GCTile, &gcv );
+    }
+    else {
+      gcv.foreground = bgcolor_;
+      cleargc_ = XCreateGC( display_, window_, GCForeground, &gcv );
+    }
+  }
+  else
+    XFreePixmap( display_, backbuffer_ );
+
+  backbuffer_ = XCreatePixmap( display_, window_, width_, height_,
+                               DefaultDepth( display_,
+                                             DefaultScreen( display_ ) ) );
+  drawable_ = backbuffer_;
+  undamage();
+  clear();
+}
+
+void XWin::clear( void ){
+  flushFills();
+  if ( backbuffer_ == None ){
+    XClearWindow( display_, window_ );
+    sent( 8 );
+  }
+  else
+    clear( 0, 0, width_, height_ );
+}
+
+void XWin::clear( int x, int y, int width, int height ){
+  flushFills();
+  if ( backbuffer_ == None ){
+    XClearArea( display_, window_, x, y, width, height, False );
+    sent( 16 );
+    return;
+  }
+  //  XClearArea() takes a width or height of 0 to mean up to the edge.
+  if ( width == 0 )
+    width = width_ - x;
+  if ( height == 0 )
+    height = height_ - y;
+  XFillRectangle( display_, backbuffer_, cleargc_, x, y, width, height );
+  sent( 20 );
+  damage( x, y, width, height );
+}
+
+//  Copies the part of the back buffer that changed since the last call
+//  to the window.
+void XWin::present( void ){
+  if ( backbuffer_ == None || damx2_ <= damx1_ || damy2_ <= damy1_ )
+    return;
+
+  if ( damx1_ < 0 ) damx1_ = 0;
+  if ( damy1_ < 0 ) damy1_ = 0;
+  if ( damx2_ > width_ ) damx2_ = width_;
+  if ( damy2_ > height_ ) damy2_ = height_;
+  if ( damx2_ > damx1_ && damy2_ > damy1_ ){
+    XCopyArea( display_, backbuffer_, window_, copygc_, damx1_, damy1_,
+               damx2_ - damx1_, damy2_ - damy1_, damx1_, damy1_ );
+    sent( 28 );
+  }
+  undamage();
+}
+
+void XWin::fillRectangle( unsigned long pixel, int stippleN,
+                          int x, int y, int width, int height ){
+  if ( width < 0 || height < 0 )
+    return;
+  if ( !doStippling_ )
+    stippleN = -1;
+
+  unsigned int i;
+  for ( i = 0 ; i < fills_.size() ; i++ )
+    if ( fills_[i].pixel == pixel && fills_[i].stipple == stippleN )
+      break;
+  if ( i == fills_.size() ){
+    fills_.push_back( FillBatch() );
+    fills_[i].pixel = pixel;
+    fills_[i].stipple = stippleN;
+  }
+
+  //  Same size as drawFilledRectangle() would draw.
+  XRectangle r;
+  r.x = x;
+  r.y = y;
+  r.width = width + 1;
+  r.height = height + 1;
+  fills_[i].rects.push_back( r );
+  nfills_++;
+  damage( x, y, width + 1, height + 1 );
+}
+
+void XWin::flushFills( void ){
+  if ( !nfills_ )
+    return;
+
+  for ( unsigned int i = 0 ; i < fills_.size() ; i++ ){
+    FillBatch &b = fills_[i];
+    if ( b.rects.empty() )
+      continue;
+    if ( b.pixel != fillPixel_ ){
+      XSetForeground( display_, fillgc_, b.pixel );
+      fillPixel_ = b.pixel;
+      gcChanges_++;
+      sent( 16 );
+    }
+    else
+      gcSkipped_++;
+    if ( b.stipple >= 0 && b.stipple != fillStipple_ ){
+      XSetStipple( display_, fillgc_, stipples_[b.stipple] );
+      fillStipple_ = b.stipple;
+      gcChanges_++;
+      sent( 16 );
+    }
+    XFillRectangles( display_, drawable_, fillgc_, &b.rects[0],
+                     b.rects.size() );
+    sent( 12 + 8 * b.rects.size() );
+    fillRequests_++;
+    b.rects.clear();
+  }
+  fillRects_ += nfills_;
+  nfills_ = 0;
+}
+
+unsigned long XWin::putImage( XImage *image, XShmSegmentInfo *shminfo,
+                              int x, int y ){
+  flushFills();
+  unsigned long serial = NextRequest( display_ );
+  if ( shminfo ){
+    XShmPutImage( display_, drawable_, gc_, image, 0, 0, x, y,
+                  image->width, image->height, False );
+    sent( 40 );
+  }
+  else {
+    XPutImage( display_, drawable_, gc_, image, 0, 0, x, y,
+               image->width, image->height );
+    sent( 24 + image->bytes_per_line * image->height );
+  }
+  damage( x, y, image->width, image->height );
+  return serial;
+}
+
+static const char GLYPHS[] = " 0123456789.%-kKMGTPEmn\265";
+
+int XWin::glyphCell( void ){
+  if ( glyphCell_ < 0 ){
+    //  No part of a character may stick out of its cell.
+    XCharStruct &min = font_->min_bounds, &max = font_->max_bounds;
+    if ( min.width == max.width && min.lbearing >= 0
+         && max.rbearing <= max.width && background_ == None )
+      glyphCell_ = max.width;
+    else
+      glyphCell_ = 0;
+  }
+  return glyphCell_;
+}
+
+bool XWin::isGlyph( char c ) const {
+  return c && strchr( GLYPHS, c );
+}
+
+void XWin::drawGlyph( unsigned long pixel, char c, int x, int top ){
+  int cell = glyphCell();
+  int height = textHeight() + 1;
+  unsigned int i;
+
+  for ( i = 0 ; i < glyphStrips_.size() ; i++ )
+    if ( glyphStrips_[i].first == pixel )
+      break;
+  if ( i == glyphStrips_.size() ){
+    int n = strlen( GLYPHS );
+    Pixmap strip = XCreatePixmap( display_, window_, n * cell, height,
+                                  DefaultDepth( display_,
+                                                DefaultScreen( display_ ) ) );
+    XGCValues gcv;
+    gcv.foreground = bgcolor_;
+    gcv.font = font_->fid;
+    GC gc = XCreateGC( display_, strip, GCForeground | GCFont, &gcv );
+    XFillRectangle( display_, strip, gc, 0, 0, n * cell, height );
+    XSetForeground( display_, gc, pixel );
+    XDrawString( display_, strip, gc, 0, height - 1, GLYPHS, n );
+    XFreeGC( display_, gc );
+    glyphStrips_.push_back( std::make_pair( pixel, strip ) );
+  }
+
+  flushFills();
+  XCopyArea( display_, glyphStrips_[i].second, drawable_, copygc_,
+             ( strchr( GLYPHS, c ) - GLYPHS ) * cell, 0, cell, height, x, top );
+  sent( 28 );
+  damage( x, top, cell, height );
+}
+
+//  Local displays are named ":0" or "unix:0" (or by a socket path, on
+//  some systems).  Anything with a host name goes over the network,
+//  even "localhost:10", which is how ssh -X forwards it.
+bool XWin::remoteDisplay( void ){
+  if ( display_ == NULL )
+    return false;
+  const char *name = DisplayString( display_ );
+
+  if ( name[0] == ':' || name[0] == '/' || !strncmp( name, "unix:", 5 ) )
+    return false;
+  return true;
+}
 //-----------------------------------------------------------------------------
 void XWin::getGeometry( void ){
   char                 default_geometry[80];
@@ -383,6 +640,9 @@ std::cerr << "Function not implemented!\n";  //  BCG  FIXME  Need to make this.
 unsigned long XWin::allocColor( const char *name ){
   XColor exact, closest;
 
+  if ( display_ == NULL )
+    return 0;
+
   if ( XAllocNamedColor( display_, colormap(), name, &closest, &exact ) == 0 )
     std::cerr <<"XWin::allocColor() : failed to alloc : " <<name <<std::endl;
 
@@ -3,9 +3,14 @@
 
 #include "Xrm.h"
 #include <string.h>
+#include <limits.h>
+#include <stdlib.h>
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
 #include <iostream>
+#include <vector>
+#include <utility>
 
 class XWin;
 
@@ -31,20 +36,33 @@ public:
   void title( const char *str ) { XStoreName( display_, window_, str ); }
   void iconname( const char *str ) { XSetIconName( display_, window_, str ); }
 
-  void clear( void ) { XClearWindow( display_, window_ ); }
-  void clear( int x, int y, int width, int height )
-    { XClearArea( display_, window_, x, y, width, height, False ); }
+  void clear( void );
+  void clear( int x, int y, int width, int height );
   unsigned long allocColor( const char *name );
+  //  The GC setters remember what gc_ was last set to, and skip the
+  //  request when nothing would change.
   void setForeground( unsigned long pixelvalue )
-    { XSetForeground( display_, gc_, pixelvalue ); }
+    { if ( pixelvalue == gcForeground_ ) { gcSkipped_++; return; }
+      XSetForeground( display_, gc_, pixelvalue );
+      gcForeground_ = pixelvalue;
+      gcChanges_++;
+      sent( 16 ); }
   void setBackground( unsigned long pixelvalue )
-    { XSetBackground( display_, gc_, pixelvalue ); }
+    { if ( pixelvalue == gcBackground_ ) { gcSkipped_++; return; }
+      XSetBackground( display_, gc_, pixelvalue );
+      gcBackground_ = pixelvalue;
+      gcChanges_++;
+      sent( 16 ); }
   void setStipple( Pixmap stipple)
     { if (!doStippling_) return;
-      XSetStipple(display_, gc_, stipple);
+      if ( stipple == gcStipple_ ) { gcSkipped_++; return; }
       XGCValues xgcv;
+      xgcv.stipple = stipple;
       xgcv.fill_style = FillOpaqueStippled;
-      XChangeGC (display_, gc_, GCFillStyle, &xgcv); }
+      XChangeGC (display_, gc_, GCStipple | GCFillStyle, &xgcv);
+      gcStipple_ = stipple;
+      gcChanges_++;
+      sent( 20 ); }
   void setStippleN (int n) {setStipple(stipples_[n]); }
   Pixmap createPixmap(const char* data, unsigned int w, unsigned int h) {
   return XCreatePixmapFromBitmapData(display_, window_,
@@ -56,20 +74,90 @@ public:
     { XResizeWindow( display_, window_, width, height ); }
   void lineWidth( int width )
     {
+      if ( width == lineWidth_ ) { gcSkipped_++; return; }
+      gcChanges_++;
       XGCValues xgcv;
       xgcv.line_width = width;
       XChangeGC( display_, gc_, GCLineWidth, &xgcv );
+      lineWidth_ = width;
+      sent( 16 );
     }
+  //  Queues a filled rectangle (the same size as drawFilledRectangle()
+  //  would draw) in the given color and stipple, to be drawn with the
+  //  other rectangles of that color and stipple in one request by
+  //  flushFills().  Any other drawing flushes the queue first, but the
+  //  queued rectangles may be drawn in any order, so they must not
+  //  overlap each other.  A full redraw of the default meters goes from
+  //  about a thousand requests (a ChangeGC and a fill per rectangle) to
+  //  about 150.
+  void fillRectangle( unsigned long pixel, int stippleN,
+                      int x, int y, int width, int height );
+  void flushFills( void );
+  //  Copies an image (shared with the server if shminfo is not NULL)
+  //  to (x, y), and returns the number of the request that did it.
+  unsigned long putImage( XImage *image, XShmSegmentInfo *shminfo,
+                          int x, int y );
+
+  //  The characters of the used labels (see UsedLabel) can be drawn
+  //  once per color into a strip of character cells, and copied from
+  //  there.  glyphCell() is the width of a cell, or 0 if the font is
+  //  not fixed width or the window has a background pixmap.  A cell is
+  //  textHeight() + 1 high, with the baseline at the bottom.
+  int glyphCell( void );
+  bool isGlyph( char c ) const;
+  void drawGlyph( unsigned long pixel, char c, int x, int top );
+
+  //  Whether rectangles are drawn with stipples (enableStipple).
+  int stippling( void ) const { return doStippling_; }
+  unsigned long fillRects( void ) const { return fillRects_; }
+  unsigned long fillRequests( void ) const { return fillRequests_; }
+  //  GC changes sent, and skipped since they would not have changed
+  //  anything.
+  unsigned long gcChanges( void ) const { return gcChanges_; }
+  unsigned long gcSkipped( void ) const { return gcSkipped_; }
+  //  Serial number of the next X request, to count requests with.
+  unsigned long nextRequest( void ) { return NextRequest( display_ ); }
+  //  Roughly how many bytes of requests have been sent, going by the
+  //  size of the drawing requests in the protocol.
+  unsigned long bytesSent( void ) const { return xbytes_; }
+
+  //  Whether the X server is on another host (or reached through a
+  //  tunnel, as with ssh -X), going by the display name.
+  bool remoteDisplay( void );
+  //  In remote mode, set before init(), stipples are not used.
+  void remote( bool val ) { remote_ = val; }
+  bool remote( void ) const { return remote_; }
+
   void drawLine( int x1, int y1, int x2, int y2 )
-    { XDrawLine( display_, window_, gc_, x1, y1, x2, y2 ); }
+    { flushFills();
+      XDrawLine( display_, drawable_, gc_, x1, y1, x2, y2 );
+      sent( 20 );
+      damage( ( x1 < x2 ? x1 : x2 ) - lineWidth_,
+              ( y1 < y2 ? y1 : y2 ) - lineWidth_,
+              abs( x2 - x1 ) + 2 * lineWidth_ + 1,
+              abs( y2 - y1 ) + 2 * lineWidth_ + 1 ); }
   void drawRectangle( int x, int y, int width, int height )
-    { XDrawRectangle( display_, window_, gc_, x, y, width, height ); }
+    { flushFills();
+      XDrawRectangle( display_, drawable_, gc_, x, y, width, height );
+      sent( 20 );
+      damage( x - lineWidth_, y - lineWidth_,
+              width + 2 * lineWidth_ + 1, height + 2 * lineWidth_ + 1 ); }
   void drawFilledRectangle( int x, int y, int width, int height )
-    { XFillRectangle( display_, window_, gc_, x, y, width + 1, height + 1 ); }
+    { flushFills();
+      XFillRectangle( display_, drawable_, gc_, x, y, width + 1, height + 1 );
+      sent( 20 );
+      damage( x, y, width + 1, height + 1 ); }
   void drawString( int x, int y, const char *str )
-    { XDrawString( display_, window_, gc_, x, y, str, strlen( str ) ); }
+    { int n = strlen( str );
+      flushFills();
+      XDrawString( display_, drawable_, gc_, x, y, str, n );
+      sent( 16 + ( ( n + 2 + 3 ) & ~3 ) );
+      damage( x, y - textAscent(), textWidth( str, n ), textHeight() ); }
   void copyArea( int src_x, int src_y, int width, int height, int dest_x, int dest_y )
-    { XCopyArea( display_, window_, window_, gc_, src_x, src_y, width, height, dest_x, dest_y ); }
+    { flushFills();
+      XCopyArea( display_, drawable_, drawable_, gc_, src_x, src_y, width, height, dest_x, dest_y );
+      sent( 28 );
+      damage( dest_x, dest_y, width, height ); }
   int textWidth( const char *str, int n )
     { return XTextWidth( font_, str, n ); }
   int textWidth( const char *str )
@@ -82,7 +170,16 @@ public:
   virtual void checkevent( void );
   void map( void ) { XMapWindow( display_, window_ ); }
   void unmap( void ) { XUnmapWindow( display_, window_ ); }
-  void flush( void ) { XFlush( display_ ); }
+  void flush( void ) { flushFills(); present(); XFlush( display_ ); }
+
+  //  With the backBuffer resource set, everything is drawn into a
+  //  pixmap the size of the window, and flush() copies the part that
+  //  changed to the window in one go.  Exposed parts of the window are
+  //  copied from it as well, with expose().
+  bool backBuffered( void ) const { return backbuffer_ != None; }
+  void setupBackBuffer( void );
+  void expose( int x, int y, int width, int height )
+    { damage( x, y, width, height ); }
 
   const char *getResource( const char *name );
   const char *getResourceOrUseDefault( const char *name, const char* defaultVal );
@@ -135,6 +232,48 @@ protected:
   Xrm*		xrmptr_;	//  Pointer to the XOSView xrm.  FIXME???
   int		doStippling_;	//  Either 0 or 1.
   Pixmap	stipples_[4];	//  Array of Stipple masks.
+  Drawable      drawable_;      //  What is drawn to: window_ or backbuffer_
+  Pixmap        backbuffer_;    //  Off-screen copy of the window, or None
+  Pixmap        background_;    //  Background pixmap, or None
+  GC            cleargc_;       //  Paints the background into backbuffer_
+  GC            copygc_;        //  Copies from our own pixmaps, without
+                                //  GraphicsExpose events
+  int           lineWidth_;     //  Line width set in gc_
+  unsigned long gcForeground_, gcBackground_;  //  Set in gc_
+  Pixmap        gcStipple_;     //  Set in gc_, or None for a solid fill
+  unsigned long fillPixel_;     //  Foreground set in fillgc_
+  int           fillStipple_;   //  Stipple set in fillgc_, or -1
+  unsigned long gcChanges_, gcSkipped_;  //  Totals, for XOSDEBUG
+  unsigned long xbytes_;        //  See bytesSent()
+  bool          remote_;
+
+  void sent( unsigned long bytes ) { xbytes_ += bytes; }
+  GC            fillgc_;        //  Draws the queued rectangles
+
+  struct FillBatch {
+    unsigned long pixel;
+    int stipple;                //  -1 for a solid fill
+    std::vector<XRectangle> rects;
+  };
+  std::vector<FillBatch> fills_;  //  Queued rectangles, by color/stipple
+
+  int glyphCell_;               //  -1 until worked out
+  std::vector<std::pair<unsigned long, Pixmap> > glyphStrips_;  //  by color
+  unsigned int nfills_;           //  Number of queued rectangles
+  unsigned long fillRects_, fillRequests_;  //  Totals, for XOSDEBUG
+  int           damx1_, damy1_, damx2_, damy2_;  //  Changed part of
+                                                 //  backbuffer_
+
+  //  An empty box, which the first damage() replaces.
+  void undamage( void )
+    { damx1_ = damy1_ = INT_MAX; damx2_ = damy2_ = INT_MIN; }
+  void damage( int x, int y, int width, int height )
+    { if ( backbuffer_ == None || width <= 0 || height <= 0 ) return;
+      if ( x < damx1_ ) damx1_ = x;
+      if ( y < damy1_ ) damy1_ = y;
+      if ( x + width > damx2_ ) damx2_ = x + width;
+      if ( y + height > damy2_ ) damy2_ = y + height; }
+  void present( void );
 
   void init( int argc, char *argv[] );
   void getGeometry( void );